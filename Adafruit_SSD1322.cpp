@@ -24,13 +24,51 @@ redistribution
 #include "Adafruit_SSD1322.h"
 #include "splash.h"
 
+#ifndef pgm_read_pointer
+#if !defined(__INT_MAX__) || (__INT_MAX__ > 0xFFFF)
+#define pgm_read_pointer(addr) ((void *)pgm_read_dword(addr))
+#else
+#define pgm_read_pointer(addr) ((void *)pgm_read_word(addr))
+#endif
+#endif
+
 // CONSTRUCTORS, DESTRUCTOR ------------------------------------------------
 
+/*!
+    @brief  Constructor for 256x64 SPI SSD1322 displays, using software
+            (bitbang) SPI.
+    @param  mosi_pin
+            MOSI (master out, slave in) pin (using Arduino pin numbering).
+            This transfers serial data from microcontroller to display.
+    @param  sclk_pin
+            SCLK (serial clock) pin (using Arduino pin numbering).
+            This clocks each bit from MOSI.
+    @param  dc_pin
+            Data/command pin (using Arduino pin numbering), selects whether
+            display is receiving commands (low) or data (high).
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used
+            (some displays might be wired to share the microcontroller's
+            reset pin).
+    @param  cs_pin
+            Chip-select pin (using Arduino pin numbering) for sharing the
+            bus with other devices. Active low.
+    @param  variant
+            Controller type, VARIANT_SSD1322 or VARIANT_SSH1122.
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SSD1322::Adafruit_SSD1322(int8_t mosi_pin,
+                                   int8_t sclk_pin, int8_t dc_pin,
+                                   int8_t rst_pin, int8_t cs_pin, 
+                                   int8_t variant)
+    : Adafruit_SSD1322(256, 64, mosi_pin, sclk_pin, dc_pin, rst_pin, cs_pin, variant) {}
+
 /*!
     @brief  Constructor for SPI SSD1322 displays, using software (bitbang)
             SPI.
     @param  w
-            Display width in pixels
+            Display width in pixels. Must be a multiple of 4.
     @param  h
             Display height in pixels
     @param  mosi_pin
@@ -49,20 +87,56 @@ redistribution
     @param  cs_pin
             Chip-select pin (using Arduino pin numbering) for sharing the
             bus with other devices. Active low.
+    @param  variant
+            Controller type, VARIANT_SSD1322 or VARIANT_SSH1122.
     @note   Call the object's begin() function before use -- buffer
-            allocation is performed there!
+            allocation is performed there! On boards with direct port
+            access the pins are then driven through the port registers
+            (see SSD1322_FAST_SOFT_SPI).
 */
-Adafruit_SSD1322::Adafruit_SSD1322(int8_t mosi_pin,
+Adafruit_SSD1322::Adafruit_SSD1322(uint16_t w, uint16_t h, int8_t mosi_pin,
                                    int8_t sclk_pin, int8_t dc_pin,
-                                   int8_t rst_pin, int8_t cs_pin, 
+                                   int8_t rst_pin, int8_t cs_pin,
                                    int8_t variant)
-    : Adafruit_GrayOLED(4, 256, 64, mosi_pin, sclk_pin, dc_pin, rst_pin, cs_pin),
-      variant(variant) {}
+    : Adafruit_GrayOLED(4, w, h, mosi_pin, sclk_pin, dc_pin, rst_pin, cs_pin),
+      variant(variant), mosiPin(mosi_pin), sclkPin(sclk_pin) {
+  init_geometry();
+}
+
+/*!
+    @brief  Constructor for 256x64 SPI SSD1322 displays, using native
+            hardware SPI.
+    @param  spi
+            Pointer to an existing SPIClass instance (e.g. &SPI, the
+            microcontroller's primary SPI bus).
+    @param  dc_pin
+            Data/command pin (using Arduino pin numbering), selects whether
+            display is receiving commands (low) or data (high).
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used
+            (some displays might be wired to share the microcontroller's
+            reset pin).
+    @param  cs_pin
+            Chip-select pin (using Arduino pin numbering) for sharing the
+            bus with other devices. Active low.
+    @param  variant
+            Controller type, VARIANT_SSD1322 or VARIANT_SSH1122.
+    @param  bitrate
+            SPI clock rate for transfers to this display. Default if
+            unspecified is 8000000UL (8 MHz).
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SSD1322::Adafruit_SSD1322(SPIClass *spi,
+                                   int8_t dc_pin, int8_t rst_pin, int8_t cs_pin,
+                                   int8_t variant,
+                                   uint32_t bitrate)
+    : Adafruit_SSD1322(256, 64, spi, dc_pin, rst_pin, cs_pin, variant, bitrate) {}
 
 /*!
     @brief  Constructor for SPI SSD1322 displays, using native hardware SPI.
     @param  w
-            Display width in pixels
+            Display width in pixels. Must be a multiple of 4.
     @param  h
             Display height in pixels
     @param  spi
@@ -78,29 +152,108 @@ Adafruit_SSD1322::Adafruit_SSD1322(int8_t mosi_pin,
     @param  cs_pin
             Chip-select pin (using Arduino pin numbering) for sharing the
             bus with other devices. Active low.
+    @param  variant
+            Controller type, VARIANT_SSD1322 or VARIANT_SSH1122.
     @param  bitrate
             SPI clock rate for transfers to this display. Default if
             unspecified is 8000000UL (8 MHz).
     @note   Call the object's begin() function before use -- buffer
             allocation is performed there!
 */
-Adafruit_SSD1322::Adafruit_SSD1322(SPIClass *spi,
+Adafruit_SSD1322::Adafruit_SSD1322(uint16_t w, uint16_t h, SPIClass *spi,
                                    int8_t dc_pin, int8_t rst_pin, int8_t cs_pin,
                                    int8_t variant,
                                    uint32_t bitrate)
-    : Adafruit_GrayOLED(4, 256, 64, spi, dc_pin, rst_pin, cs_pin, bitrate),
-      variant(variant) {}
+    : Adafruit_GrayOLED(4, w, h, spi, dc_pin, rst_pin, cs_pin, bitrate),
+      variant(variant), spi_bus(spi) {
+  init_geometry();
+}
+
+/*!
+    @brief  Constructor for 256x64 SSD1322 displays driven over some other
+            bus, such as Adafruit_SSD1322_Parallel.
+    @param  transport
+            The bus, which looks after its own D/C and chip select pins.
+            It must outlive the display.
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used.
+    @param  variant
+            Controller type, VARIANT_SSD1322 or VARIANT_SSH1122.
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SSD1322::Adafruit_SSD1322(Adafruit_SSD1322_Transport *transport,
+                                   int8_t rst_pin, int8_t variant)
+    : Adafruit_SSD1322(256, 64, transport, rst_pin, variant) {}
+
+/*!
+    @brief  Constructor for SSD1322 displays driven over some other bus,
+            such as Adafruit_SSD1322_Parallel.
+    @param  w
+            Display width in pixels. Must be a multiple of 4.
+    @param  h
+            Display height in pixels
+    @param  transport
+            The bus, which looks after its own D/C and chip select pins.
+            It must outlive the display.
+    @param  rst_pin
+            Reset pin (using Arduino pin numbering), or -1 if not used.
+    @param  variant
+            Controller type, VARIANT_SSD1322 or VARIANT_SSH1122.
+    @note   Call the object's begin() function before use -- buffer
+            allocation is performed there!
+*/
+Adafruit_SSD1322::Adafruit_SSD1322(uint16_t w, uint16_t h,
+                                   Adafruit_SSD1322_Transport *transport,
+                                   int8_t rst_pin, int8_t variant)
+    : Adafruit_GrayOLED(4, w, h, (TwoWire *)NULL, rst_pin), variant(variant),
+      transport(transport) {
+  init_geometry();
+}
+
+// Work out where the panel sits in display RAM.
+void Adafruit_SSD1322::init_geometry()
+{
+	if (is_ssd1322()) {
+		// The SSD1322 has 480 pixels (120 4-pixel columns) of RAM per row,
+		// and panels narrower than that are wired to the middle of it.
+		// For the usual 256 pixel panel this is column 0x1c.
+		column_offset = (480 - WIDTH) / 8;
+	} else {
+		// The SH1122 only has RAM for 256 pixels, starting at column 0.
+		column_offset = 0;
+	}
+	band_y2 = HEIGHT - 1;
+}
 
 /*!
     @brief  Destructor for Adafruit_SSD1322 object.
 */
-Adafruit_SSD1322::~Adafruit_SSD1322(void) {}
+Adafruit_SSD1322::~Adafruit_SSD1322(void) {
+  // Finishes any update in flight before freeing its buffer.
+  enableAsyncDisplay(false);
+  enableVsync(false);
+  if (shadow) {
+    free(shadow);
+    shadow = NULL;
+  }
+  if (luminance_lut) {
+    free(luminance_lut);
+    luminance_lut = NULL;
+  }
+  if (stats) {
+    free(stats);
+    stats = NULL;
+  }
+}
 
 // Register definitions
 
 #define SSD1322_BLACK 0x0
 #define SSD1322_WHITE 0xF
 
+#define SSD1322_ENABLEGRAYSCALETABLE 0x00
+
 #define SSD1322_SETCOLUMN 0x15
 
 #define SSD1322_WRITERAM 0x5C
@@ -115,6 +268,7 @@ Adafruit_SSD1322::~Adafruit_SSD1322(void) {}
 #define SSD1322_NORMALDISPLAY 0xA6
 #define SSD1322_INVERTDISPLAY 0xA7
 #define SSD1322_SETMULTIPLEX 0xA8
+#define SSD1322_ENTERPARTIALDISPLAY 0xA8
 #define SSD1322_EXITPARTIALDISPLAY 0xA9
 #define SSD1322_REGULATOR 0xAB
 #define SSD1322_DISPLAYOFF 0xAE
@@ -176,12 +330,137 @@ Adafruit_SSD1322::~Adafruit_SSD1322(void) {}
 bool Adafruit_SSD1322::begin(bool reset) {
 
 	// set pin directions (superclass takes care of dcPin and rstPin)
-	pinMode(csPin, OUTPUT);
+	if (csPin >= 0) {
+		pinMode(csPin, OUTPUT);
+	}
+
+	// A partial display strip is too small for the whole screen.
+	if (partial_rows) {
+		free(buffer);
+		buffer = NULL;
+		partial_rows = 0;
+		band_y1 = 0;
+		band_y2 = HEIGHT - 1;
+		dirty_count = 0;
+	}
+
+	if (transport) {
+		// Adafruit_GrayOLED::_init() only knows about SPI and I2C.
+		if (!buffer && !(buffer = (uint8_t *)malloc(WIDTH * HEIGHT / 2))) {
+			return false;
+		}
+		if (!begin_bus(reset)) {
+			return false;
+		}
+		clearDisplay();
+	} else if (!Adafruit_GrayOLED::_init(0, reset)) {
+		// The SSD1322 doesn't support I2C, so the address will never be used.
+		return false;
+	}
+
+	init_controller();
+	return true;
+}
+
+/*!
+    @brief  Like begin(), but only allocates a buffer for a band of rows
+            rather than the whole screen (1 KB for 8 rows of a 256 pixel
+            wide panel, instead of 8 KB). The screen is then drawn with
+            renderBands() instead of drawing and calling display().
+    @param  rows
+            Height of each band. Taller bands use more RAM but mean fewer
+            calls to the draw callback.
+    @param  reset
+            As for begin().
+    @return true on successful allocation/init, false otherwise.
+    @note   The shadow buffer, asynchronous display and scrollVertical()
+            all need the whole frame, so are not available in band mode.
+*/
+bool Adafruit_SSD1322::beginBanded(uint8_t rows, bool reset)
+{
+	if (rows == 0) {
+		return false;
+	}
+	if (rows > HEIGHT) {
+		rows = HEIGHT;
+	}
+	enableShadowBuffer(false);
+	enableAsyncDisplay(false);
+
+	if (csPin >= 0) {
+		pinMode(csPin, OUTPUT);
+	}
+
+	if (buffer) {
+		free(buffer);
+	}
+	buffer = (uint8_t *)malloc(rows * (WIDTH / 2));
+	if (!buffer) {
+		band_rows = 0;
+		return false;
+	}
+	band_rows = rows;
+	partial_rows = 0;
+	band_y1 = 0;
+	band_y2 = rows - 1;
+	memset(buffer, 0, rows * (WIDTH / 2));
+	reset_window();
+	dirty_count = 0;
 
-	// The SSD1322 doesn't support I2C, so the address will never be used.
-	if (!Adafruit_GrayOLED::_init(0, reset)) {
+	if (!begin_bus(reset)) {
 		return false;
 	}
+	init_controller();
+	return true;
+}
+
+// Reset the panel and start the bus, as Adafruit_GrayOLED::_init() does, for
+// when the buffer has been allocated here instead.
+bool Adafruit_SSD1322::begin_bus(bool reset)
+{
+	if (reset && (rstPin >= 0)) {
+		pinMode(rstPin, OUTPUT);
+		digitalWrite(rstPin, HIGH);
+		delay(10);
+		digitalWrite(rstPin, LOW);
+		delay(10);
+		digitalWrite(rstPin, HIGH);
+		delay(10);
+	}
+	if (transport) {
+		return transport->begin();
+	}
+	pinMode(dcPin, OUTPUT);
+	return spi_dev->begin();
+}
+
+// Send the controller its init sequence and turn the display on.
+void Adafruit_SSD1322::init_controller()
+{
+#if defined(BUSIO_USE_FAST_PINIO)
+	if (dcPin >= 0) {
+		dcPort = (BusIO_PortReg *)portOutputRegister(digitalPinToPort(dcPin));
+		dcPinMask = digitalPinToBitMask(dcPin);
+	}
+	if (csPin >= 0) {
+		csPort = (BusIO_PortReg *)portOutputRegister(digitalPinToPort(csPin));
+		csPinMask = digitalPinToBitMask(csPin);
+	}
+#if SSD1322_FAST_SOFT_SPI
+	if (!spi_bus && (mosiPin >= 0) && (sclkPin >= 0)) {
+		// Adafruit_SPIDevice::begin() has already made these outputs, with
+		// the clock idling low.
+		mosiPort = (BusIO_PortReg *)portOutputRegister(digitalPinToPort(mosiPin));
+		mosiPinMask = digitalPinToBitMask(mosiPin);
+		clkPort = (BusIO_PortReg *)portOutputRegister(digitalPinToPort(sclkPin));
+		clkPinMask = digitalPinToBitMask(sclkPin);
+		fast_soft_spi = true;
+	}
+#endif
+#endif
+
+	// Send the whole init sequence in one transaction.
+	begin_batch();
 
 	// Init sequence. For SSD1322, his is copied from the initialization in:
 	// https://github.com/winneymj/ESP8266_SSD1322
@@ -190,27 +469,23 @@ bool Adafruit_SSD1322::begin(bool reset) {
 	// For SH1122, it is derived from 8051 the example code here:
 	// https://www.buydisplay.com/white-2-08-inch-graphic-oled-display-panel-256x64-parallel-spi-i2c
 
-	if (variant == VARIANT_SSD1322) {
+	if (is_ssd1322()) {
 		spi_command(SSD1322_CMDLOCK, // 0xFD
 		0x12);// Unlock OLED driver IC
 
 		spi_command(SSD1322_DISPLAYOFF);// 0xAE
 
-		spi_command(SSD1322_DCLK,// 0xB3
-		0x91);
+		send_display_clock(false); // 0xB3
 
 		spi_command(SSD1322_SETMUXRATIO, // 0xCA
-		0x3F);// duty = 1/64
+		HEIGHT - 1);// duty = 1/HEIGHT
 
-		spi_command(SSD1322_SETDISPLAYOFFSET, // 0xA2
-		0x00);
+		send_display_offset(0); // 0xA2
 
 		spi_command(SSD1322_SETSTARTLINE, // 0xA1
 		0x00);
 
-		spi_command(SSD1322_SEGREMAP, // 0xA0
-		0x14, //Horizontal address increment,Disable Column Address Re-map,Enable Nibble Re-map,Scan from COM[N-1] to COM0,Disable COM Split Odd Even
-		0x11);//Enable Dual COM mode
+		send_remap(); // 0xA0
 
 		spi_command(SSD1322_SETGPIO, // 0xB5
 		0x00);// Disable GPIO Pins Input
@@ -224,7 +499,7 @@ bool Adafruit_SSD1322::begin(bool reset) {
 
 		spi_command(SSD1322_SETCONTRASTCURRENT, // 0xC1
 		// 0xFF);// 0xFF - default is 0x7f
-		0x80);
+		contrast);
 
 		spi_command(SSD1322_MASTERCURRENTCONTROL, // 0xC7
 		0x0F);// default is 0x0F
@@ -252,7 +527,7 @@ bool Adafruit_SSD1322::begin(bool reset) {
 
 		spi_command(SSD1322_EXITPARTIALDISPLAY);// 0xA9
 	}
-	else if (variant == VARIANT_SSH1122) {
+	else {
 		
 		// Display Off (0xAE/0xAF)
 		spi_command(SSD1322_DISPLAYOFF);
@@ -261,10 +536,10 @@ bool Adafruit_SSD1322::begin(bool reset) {
 		spi_command(SH1122_SETSTARTLINE); 
 
 		// Set brightness 
-		spi_command(SH1122_SETCONTRAST, 0x80);
+		spi_command(SH1122_SETCONTRAST, contrast);
 
-		// Set segment re-map   The right (0) or left(1) rotation
-		spi_command(SSD1322_SEGREMAP | 0);
+		// Set segment re-map and common output scan direction
+		send_remap();
 
 		// 0xA4=normal display ; 0xA5=Entire Display ON
 		spi_command(SSD1322_DISPLAYALLOFF);
@@ -272,8 +547,8 @@ bool Adafruit_SSD1322::begin(bool reset) {
 		// 0x00=normal display; 0x01=reverse display
 		spi_command(SSD1322_DISPLAYALLOFF);
 
-		// Set multiplex ratio to 1/64 Duty (0x0F~0x3F) (default is 0x3F)
-		spi_command(SSD1322_SETMULTIPLEX, 0x3F);
+		// Set multiplex ratio to 1/HEIGHT Duty (0x0F~0x3F) (default is 0x3F)
+		spi_command(SSD1322_SETMULTIPLEX, HEIGHT - 1);
 
 		// Set the DC-DC voltage and the switch frequency
 		spi_command(SH1122_DC_DC_CONTROL, 0x80);
@@ -281,14 +556,11 @@ bool Adafruit_SSD1322::begin(bool reset) {
 		// Set Row Address
 		spi_command(SH1122_SETROW, 0x00);
 
-		// Common output scan direction: C0= scan from COM0 to COM[N-1}; C8=scan From COM[N-1] to COM0
-		spi_command(SH1122_OUTPUT_SCAN_DIRECTION_UP);
-
 		// Set Display Offset
-		spi_command(SH1122_DISPLAY_OFFSET, 0x00);
+		send_display_offset(0);
 
 		// Set Display clock (default is 0x50, 0x90 is 80 Frames/Sec)
-		spi_command(SH1122_DISPLAY_CLOCK, 0x90);
+		send_display_clock(false);
 		
 		// Set Dis-Charge/Pre-Charge Period 
 		spi_command(SH1122_PRECHARGE_PERIOD, 0x76);
@@ -320,6 +592,11 @@ bool Adafruit_SSD1322::begin(bool reset) {
 	// Set_Discharge_Voltage_VSL(0x30);		//Set the discharbe voltage level		  
 	}
 
+	end_batch();
+
+	// Display RAM powers up full of noise, so this also clears it before the display is turned on.
+	calibrate_costs();
+
 	delay(100);                      // 100ms delay recommended
 
 	spi_command(SSD1322_DISPLAYON); // 0xaf
@@ -327,175 +604,3573 @@ bool Adafruit_SSD1322::begin(bool reset) {
   // The default "set contrast" command (0x81) doesn't appear in the SSD1322 datasheet.
   // Calling this might be bad?
 //   setContrast(0x2F);
+}
+
+// Set the scan directions, upside down if the controller is doing 180
+// degrees of the rotation.
+void Adafruit_SSD1322::send_remap()
+{
+	if (is_ssd1322()) {
+		spi_command(SSD1322_SEGREMAP,
+		// Horizontal address increment, Enable Nibble Re-map, Disable COM Split Odd Even, and either
+		// Disable Column Address Re-map, Scan from COM[N-1] to COM0 or
+		// Enable Column Address Re-map, Scan from COM0 to COM[N-1]
+		flipped ? 0x06 : 0x14,
+		0x11); // Enable Dual COM mode
+	} else {
+		// The right (0) or left (1) rotation
+		spi_command(SSD1322_SEGREMAP | (flipped ? 1 : 0));
+		// C0 = scan from COM0 to COM[N-1]; C8 = scan from COM[N-1] to COM0
+		spi_command(flipped ? SH1122_OUTPUT_SCAN_DIRECTION_DOWN : SH1122_OUTPUT_SCAN_DIRECTION_UP);
+	}
+}
+
+// Set the display clock, either the normal one or the slower one used
+// while idle.
+void Adafruit_SSD1322::send_display_clock(bool slow)
+{
+	if (is_ssd1322()) {
+		display_clock = slow ? SSD1322_IDLE_DCLK : 0x91;
+		spi_command(SSD1322_DCLK, display_clock);
+	} else {
+		display_clock = slow ? SH1122_IDLE_DISPLAY_CLOCK : 0x90;
+		spi_command(SH1122_DISPLAY_CLOCK, display_clock);
+	}
+}
+
+// Move the picture up by a number of rows, for setPixelShift().
+void Adafruit_SSD1322::send_display_offset(uint8_t rows)
+{
+	if (is_ssd1322()) {
+		spi_command(SSD1322_SETDISPLAYOFFSET, rows);
+	} else {
+		spi_command(SH1122_DISPLAY_OFFSET, rows);
+	}
+}
+
+// Number of rows of display RAM, which the start line wraps around.
+uint16_t Adafruit_SSD1322::ram_rows()
+{
+	return is_ssd1322() ? 128 : 64;
+}
 
-  return true; // Success
+// Map a frame buffer row to the display RAM row it is shown from.
+uint16_t Adafruit_SSD1322::physical_row(uint16_t row)
+{
+	return (row + start_line) % ram_rows();
 }
 
-void Adafruit_SSD1322::start_write(uint16_t start_column, uint16_t start_row, uint16_t end_column, uint16_t end_row)
+/*!
+    @brief  Set up display RAM addressing for a window of the frame buffer.
+            Rows are frame buffer rows; if the window wraps around the end
+            of display RAM, only the part before the wrap is addressed.
+    @return The last frame buffer row covered by the window.
+*/
+uint16_t Adafruit_SSD1322::start_write(uint16_t start_column, uint16_t start_row, uint16_t end_column, uint16_t end_row)
 {
-	if (variant == VARIANT_SSD1322) {
+	uint16_t ring = ram_rows();
+	uint16_t physical_start = physical_row(start_row);
+	uint16_t last_row = min(end_row, uint16_t(start_row + (ring - 1 - physical_start)));
+	if (stats) {
+		stats->windows++;
+	}
+
+	if (is_ssd1322()) {
+		// The dirty window seems to need to be expanded by 1 in y.
+		uint16_t physical_end = min(uint16_t(physical_row(last_row) + 1), uint16_t(ring - 1));
+
 		// This variant wants a full window (including width/height) and auto-increments if it's not the full display width.
-		spi_command(SSD1322_SETCOLUMN, uint8_t(start_column + 0x1c), uint8_t(end_column + 0x1c));
-		spi_command(SSD1322_SETROW, uint8_t(start_row), uint8_t(end_row));
+		spi_command(SSD1322_SETCOLUMN, uint8_t(start_column + column_offset), uint8_t(end_column + column_offset));
+		spi_command(SSD1322_SETROW, uint8_t(physical_start), uint8_t(physical_end));
 		spi_command(SSD1322_WRITERAM);
 	}
+	return last_row;
 }
 
 void Adafruit_SSD1322::continue_write(uint16_t column, uint16_t row)
 {
-	if (variant == VARIANT_SSH1122) {
+	if (is_sh1122()) {
 		// Column is in the right format for the SSD1322. The SH1122 wants it doubled.
 		column <<= 1;
 		// We need to set a new column and row address for each line.
 		spi_command(SH1122_SETCOLUMN | ((column >> 4) & 0x07), column & 0x0F);
-		spi_command(SH1122_SETROW, row);
+		spi_command(SH1122_SETROW, physical_row(row));
 	}
 }
 
+// DRAWING PRIMITIVES ------------------------------------------------------
+
 /*!
-    @brief  Do the actual writing of the internal frame buffer to display RAM
+    @brief  Set a single pixel in the frame buffer.
+    @param  x
+            Column, 0 at left
+    @param  y
+            Row, 0 at top
+    @param  color
+            Gray level, 0 (off) to 15 (brightest)
+    @note   Same as the superclass version, except that in band mode only
+            rows in the current band are drawn.
 */
-void Adafruit_SSD1322::display(void) {
-	// ESP8266 needs a periodic yield() call to avoid watchdog reset.
-	// With the limited size of SSD1322 displays, and the fast bitrate
-	// being used (1 MHz or more), I think one yield() immediately before
-	// a screen write and one immediately after should cover it.  But if
-	// not, if this becomes a problem, yields() might be added in the
-	// 32-byte transfer condition below.
-	yield();
-
-	// If the dirty window is empty, early-exit.
-	if ((window_x1 > window_x2) || (window_y1 > window_y2))
-	{
-		window_x1 = 1024;
-		window_y1 = 1024;
-		window_x2 = -1;
-		window_y2 = -1;
+void Adafruit_SSD1322::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+	if ((x < 0) || (y < 0) || (x >= width()) || (y >= height())) {
 		return;
 	}
-
-	uint8_t *ptr = buffer;
-	uint8_t rows = HEIGHT;
-
-	uint8_t bytes_per_row = WIDTH / 2;
-
-	// On the SH1122, the "bytes == bytes_per_row" case seems to be faster for most cases
-	// (even with writing more data, apparently the reduced overhead is a win).
-	// Expand the window to the full width of the display to take advantage of this.
-	// Only do this if we're above a certain width threshold, since it might not be a win for very narrow blits.
-	if ((variant == VARIANT_SSH1122) &&
-		(window_x2 - window_x1 > 16)) {
-		window_x1 = 0;
-		window_x2 = WIDTH - 1;
+	int16_t t;
+	switch (buffer_rotation()) {
+	case 1:
+		t = x;
+		x = WIDTH - y - 1;
+		y = t;
+		break;
+	case 2:
+		x = WIDTH - x - 1;
+		y = HEIGHT - y - 1;
+		break;
+	case 3:
+		t = x;
+		x = y;
+		y = HEIGHT - t - 1;
+		break;
+	}
+	if ((y < band_y1) || (y > band_y2)) {
+		return;
 	}
 
-	// Column addresses seem to be in 2-byte (4-pixel) units.
-	int16_t start_column = min(int16_t((WIDTH/4)), int16_t(window_x1 / 4));
-	int16_t end_column = max(int16_t(0), int16_t(window_x2 / 4));
-
-	int16_t start_row = min(int16_t(rows - 1), int16_t(window_y1));
-	// The dirty window seems to need to be expanded by 1 in y.
-	int16_t end_row = max(int16_t(0), int16_t(window_y2 + 1));
+	uint8_t *ptr = row_ptr(y) + x / 2;
+	if (x & 1) {
+		*ptr = (*ptr & 0xF0) | (color & 0x0F);
+	} else {
+		*ptr = (*ptr & 0x0F) | ((color & 0x0F) << 4);
+	}
+	window_x1 = min(window_x1, x);
+	window_y1 = min(window_y1, y);
+	window_x2 = max(window_x2, x);
+	window_y2 = max(window_y2, y);
+}
 
-	start_write(start_column, start_row, end_column, end_row);
+/*!
+    @brief  Read a single pixel of the frame buffer.
+    @param  x
+            Column, 0 at left
+    @param  y
+            Row, 0 at top
+    @return Gray level, 0 to 15, or 0 outside the display or, in band mode,
+            outside the current band.
+    @note   Unlike the superclass version, this follows setHardwareFlip()
+            and band mode.
+*/
+uint8_t Adafruit_SSD1322::getPixel(int16_t x, int16_t y)
+{
+	if ((x < 0) || (y < 0) || (x >= width()) || (y >= height())) {
+		return 0;
+	}
+	int16_t w = 1;
+	int16_t h = 1;
+	rotate_rect(x, y, w, h);
+	if ((y < band_y1) || (y > band_y2)) {
+		return 0;
+	}
+	uint8_t v = row_ptr(y)[x / 2];
+	return (x & 1) ? (v & 0x0F) : (v >> 4);
+}
 
-	// Need to write two bytes for every column.
-	size_t bytes = (end_column - start_column + 1) * 2;
+/*!
+    @brief  Clear the frame buffer (or the current band) and mark it dirty.
+*/
+void Adafruit_SSD1322::clearDisplay(void)
+{
+	fillScreen(SSD1322_BLACK);
+}
 
-	if (bytes == bytes_per_row)
-	{
-		// Contiguous write case -- just write the entire buffer
-		continue_write(start_column, start_row);
-		bytes *= end_row - start_row;
-		ptr = buffer + (uint16_t)start_row * (uint16_t)bytes_per_row;
-		ptr += (start_column * 2);
-		// Write the entire buffer in one go.
-		// Serial.printf("contiguous write %d, %d -> %d (%d)\n", start_column, start_row, end_row, bytes);
-		spi_data(ptr, bytes);
-	}
-	else
-	{
-		// Serial.printf("writing %d rows at %d bytes each\n", int(end_row - start_row), int(bytes));
+/*!
+    @brief  Set the rotation of the display, as Adafruit_GFX does. Filled
+            rectangles and lines are turned into rectangles in the frame
+            buffer, and text and 1bpp bitmaps are written straight into it,
+            so every rotation draws at close to the speed of rotation 0.
+    @param  r
+            0 to 3, in steps of 90 degrees clockwise
+    @note   With setHardwareFlip() enabled, switching between rotations 0
+            or 1 and 2 or 3 turns the contents of the frame buffer around
+            and sends the whole screen on the next display().
+*/
+void Adafruit_SSD1322::setRotation(uint8_t r)
+{
+	Adafruit_GrayOLED::setRotation(r);
+	update_flip();
+}
 
-		for (uint8_t row = start_row; row < end_row; row++) 
-		{
-			continue_write(start_column, row);
-			ptr = buffer + (uint16_t)row * (uint16_t)bytes_per_row;
+/*!
+    @brief  Let the controller do 180 degrees of the rotation by scanning
+            the panel the other way around. Rotation 2 then needs no
+            transform at all in software, and rotation 3 only the one for
+            rotation 1.
+    @param  enable
+            true to use the controller's remapping, false to do all of the
+            rotation in software
+*/
+void Adafruit_SSD1322::setHardwareFlip(bool enable)
+{
+	hardware_flip = enable;
+	update_flip();
+}
 
-			// fast forward to dirty rectangle beginning
-			ptr += (start_column * 2);
+// Bring the controller's scan direction and the frame buffer in line with
+// the rotation and setHardwareFlip().
+void Adafruit_SSD1322::update_flip()
+{
+	bool flip = hardware_flip && (rotation & 2);
+	if (flip == flipped) {
+		return;
+	}
+	waitForDisplay();
+	fold_window();
+	flipped = flip;
+	if (!buffer) {
+		// Not started yet; begin() sends the right scan direction.
+		return;
+	}
 
-			// Write the entire contents of this row in one go.
-			// Serial.printf("row write %d, %d (%d)\n", start_column, row, bytes);
-			spi_data(ptr, bytes);
-			// yield();
+	begin_batch();
+	send_remap();
+	end_batch();
 
+	// Keep what's already been drawn the right way up, and a partial
+	// display strip on the same rows of the panel. In band mode the bands
+	// are drawn from scratch each time, so there's nothing to keep.
+	if (!band_rows) {
+		uint8_t *head = buffer;
+		uint8_t *tail = buffer + (band_y2 - band_y1 + 1) * (WIDTH / 2) - 1;
+		while (head < tail) {
+			uint8_t t = *head;
+			*head++ = (*tail >> 4) | (*tail << 4);
+			*tail-- = (t >> 4) | (t << 4);
+		}
+		if (head == tail) {
+			*head = (*head >> 4) | (*head << 4);
 		}
+		if (partial_rows) {
+			int16_t y1 = HEIGHT - 1 - band_y2;
+			band_y2 = HEIGHT - 1 - band_y1;
+			band_y1 = y1;
+			begin_batch();
+			send_partial_display();
+			end_batch();
+		}
+		dirty_count = 0;
+		dirty_rect all = {0, band_y1, int16_t(WIDTH - 1), band_y2};
+		add_dirty(all);
 	}
-
-	// reset dirty window
-	window_x1 = 1024;
-	window_y1 = 1024;
-	window_x2 = -1;
-	window_y2 = -1;
+	// Display RAM is now shown the other way around, so it no longer matches.
+	shadow_valid = false;
 }
 
-void Adafruit_SSD1322::spi_command(uint8_t c)
+// Turn a rectangle in rotated coordinates (with w and h positive) into the
+// rectangle it covers in the frame buffer.
+void Adafruit_SSD1322::rotate_rect(int16_t &x, int16_t &y, int16_t &w, int16_t &h)
 {
-  // Serial.printf("command: %02x\n", c);
-  spi_command_data(c, (uint8_t*)NULL, 0);
+	int16_t t;
+	switch (buffer_rotation()) {
+	case 1:
+		t = x;
+		x = WIDTH - y - h;
+		y = t;
+		t = w;
+		w = h;
+		h = t;
+		break;
+	case 2:
+		x = WIDTH - x - w;
+		y = HEIGHT - y - h;
+		break;
+	case 3:
+		t = y;
+		y = HEIGHT - x - w;
+		x = t;
+		t = w;
+		w = h;
+		h = t;
+		break;
+	}
 }
 
-void Adafruit_SSD1322::spi_command(uint8_t c, uint8_t d1)
+// Fill pixels x1 to x2 (inclusive) of one frame buffer row. Whole bytes are
+// filled with memset(), which the toolchain implements with word-wide
+// stores, and only the partial nibbles at the ends are read back.
+void Adafruit_SSD1322::fill_span(uint8_t *row, int16_t x1, int16_t x2, uint8_t color)
 {
-  // Serial.printf("command: %02x %02x\n", c, d1);
-  spi_command_data(c, &d1, 1);
+	color &= 0x0F;
+	// Even pixels are in the high nibble.
+	if (x1 & 1) {
+		row[x1 / 2] = (row[x1 / 2] & 0xF0) | color;
+		x1++;
+	}
+	if ((x1 <= x2) && !(x2 & 1)) {
+		row[x2 / 2] = (row[x2 / 2] & 0x0F) | (color << 4);
+		x2--;
+	}
+	if (x1 <= x2) {
+		memset(row + x1 / 2, color | (color << 4), (x2 - x1 + 1) / 2);
+	}
 }
 
-void Adafruit_SSD1322::spi_command(uint8_t c, uint8_t d1, uint8_t d2)
+/*!
+    @brief  Draw a filled rectangle, writing whole bytes of the frame buffer
+            at a time, and updating the dirty window once for the whole
+            rectangle. In other rotations the rectangle is turned into the
+            one it covers in the frame buffer first.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
 {
-  // Serial.printf("command: %02x %02x %02x\n", c, d1, d2);
-  uint8_t buf[] = {d1, d2};
-  spi_command_data(c, buf, 2);
-}
+	if (w < 0) {
+		x += w + 1;
+		w = -w;
+	}
+	if (h < 0) {
+		y += h + 1;
+		h = -h;
+	}
+	rotate_rect(x, y, w, h);
+	int16_t x1 = max(x, int16_t(0));
+	int16_t y1 = max(y, band_y1);
+	int16_t x2 = min(int16_t(x + w - 1), int16_t(WIDTH - 1));
+	int16_t y2 = min(int16_t(y + h - 1), band_y2);
+	if ((x1 > x2) || (y1 > y2)) {
+		return;
+	}
 
-void Adafruit_SSD1322::spi_command_data(uint8_t c, uint8_t *data, size_t count)
-{
-	digitalWrite(dcPin, LOW);
-	spi_dev->write(&c, 1);
-	if (count > 0) {
-		if (variant == VARIANT_SSD1322) {
-			// The SSD1322 wants DC pulled high for subsequent bytes of multi-byte commands
-			spi_data(data, count);
-		} else {
-			// The SSH1122 wants DC to stay low for all command bytes
-			spi_dev->write(data, count);
+	uint16_t bytes_per_row = WIDTH / 2;
+	startWrite();
+	if ((x1 == 0) && (x2 == WIDTH - 1)) {
+		// Full-width rows are contiguous in the buffer.
+		uint8_t c = color & 0x0F;
+		memset(row_ptr(y1), c | (c << 4), (y2 - y1 + 1) * bytes_per_row);
+	} else {
+		for (int16_t row = y1; row <= y2; row++) {
+			fill_span(row_ptr(row), x1, x2, color);
 		}
 	}
+	window_x1 = min(window_x1, x1);
+	window_y1 = min(window_y1, y1);
+	window_x2 = max(window_x2, x2);
+	window_y2 = max(window_y2, y2);
+	endWrite();
 }
 
-void Adafruit_SSD1322::spi_data(uint8_t *data, size_t count)
+/*!
+    @brief  Draw a horizontal line using fillRect().
+    @param  x
+            Left end of the line
+    @param  y
+            Row of the line
+    @param  w
+            Length in pixels
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
 {
-  digitalWrite(dcPin, HIGH);
-  spi_dev->write(data, count);    
+	fillRect(x, y, w, 1, color);
 }
 
 /*!
-    @brief  Enable or disable display invert mode (white-on-black vs
-            black-on-white). Handy for testing!
-    @param  i
-            If true, switch to invert mode (black-on-white), else normal
-            mode (white-on-black).
+    @brief  Draw a vertical line using fillRect().
+    @param  x
+            Column of the line
+    @param  y
+            Top end of the line
+    @param  h
+            Length in pixels
+    @param  color
+            Gray level, 0 to 15
 */
-void Adafruit_SSD1322::invertDisplay(bool i) {
-  spi_command(i ? SSD1322_INVERTDISPLAY : SSD1322_NORMALDISPLAY);
+void Adafruit_SSD1322::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+	fillRect(x, y, 1, h, color);
 }
 
-void Adafruit_SSD1322::setContrast(uint8_t level)
+/*!
+    @brief  Fill the whole screen with one gray level. This doesn't depend
+            on the rotation, so it is always a single memset().
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322::fillScreen(uint16_t color)
 {
-	if (variant == VARIANT_SSD1322) {
-		spi_command(SSD1322_SETCONTRASTCURRENT, level);
-	} else if (variant == VARIANT_SSH1122) {
-		spi_command(SH1122_SETCONTRAST, level);
+	uint8_t c = color & 0x0F;
+	memset(buffer, c | (c << 4), (band_y2 - band_y1 + 1) * (WIDTH / 2));
+	startWrite();
+	window_x1 = 0;
+	window_y1 = band_y1;
+	window_x2 = WIDTH - 1;
+	window_y2 = band_y2;
+	endWrite();
+}
+
+// 1BPP BITMAPS AND TEXT ---------------------------------------------------
+
+// Expands 4 pixels of a 1bpp bitmap (MSB = leftmost pixel) into the nibble
+// mask for the 2 frame buffer bytes they cover. Two lookups handle each
+// source byte; a full 256-entry table would cost 1 KB of flash for the
+// same amount of work per byte on 8-bit parts.
+static const uint16_t PROGMEM expand_nibble[16] = {
+    0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+    0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF};
+
+// Read count (up to 8) bits of a 1bpp bitmap starting at any bit offset,
+// MSB-aligned, with any bits past count cleared.
+static inline uint8_t read_bits(const uint8_t *src, uint16_t bit, uint8_t count, bool progmem)
+{
+	const uint8_t *p = src + (bit >> 3);
+	uint8_t shift = bit & 7;
+	uint8_t bits = (progmem ? pgm_read_byte(p) : *p) << shift;
+	if (shift && (count > 8 - shift)) {
+		bits |= (progmem ? pgm_read_byte(p + 1) : p[1]) >> (8 - shift);
+	}
+	if (count < 8) {
+		bits &= 0xFF << (8 - count);
+	}
+	return bits;
+}
+
+/*!
+    @brief  Expand a 1bpp bitmap into the frame buffer, 8 source pixels at a
+            time. Handles clipping, bitmaps that don't start on a byte
+            boundary, and odd x positions. Other rotations are handed to
+            blit_1bpp_rotated().
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  src
+            Bitmap data, MSB first
+    @param  stride
+            Distance in bits between the starts of two rows of the bitmap
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  progmem
+            true if src is in PROGMEM
+    @param  fg
+            Gray level for set bits
+    @param  bg
+            Gray level for clear bits, if opaque is true
+    @param  opaque
+            false to leave the frame buffer unchanged under clear bits
+*/
+void Adafruit_SSD1322::blit_1bpp(int16_t x, int16_t y, const uint8_t *src, uint16_t stride,
+                                 int16_t w, int16_t h, bool progmem, uint8_t fg, uint8_t bg,
+                                 bool opaque)
+{
+	if (buffer_rotation() != 0) {
+		blit_1bpp_rotated(x, y, src, stride, w, h, progmem, fg, bg, opaque);
+		return;
+	}
+
+	uint32_t bit = 0;
+	if (x < 0) {
+		bit = -x;
+		w += x;
+		x = 0;
+	}
+	if (x + w > WIDTH) {
+		w = WIDTH - x;
+	}
+	if (y < band_y1) {
+		bit += uint32_t(band_y1 - y) * stride;
+		h -= band_y1 - y;
+		y = band_y1;
+	}
+	if (y + h - 1 > band_y2) {
+		h = band_y2 - y + 1;
+	}
+	if ((w <= 0) || (h <= 0)) {
+		return;
+	}
+	src += bit >> 3;
+	bit &= 7;
+
+	uint8_t f = (fg & 0x0F) * 0x11;
+	uint8_t b = (bg & 0x0F) * 0x11;
+
+	startWrite();
+	for (int16_t j = 0; j < h; j++, bit += stride) {
+		uint8_t *dst = row_ptr(y + j) + x / 2;
+		uint32_t row_bit = bit;
+		int16_t n = w;
+
+		if (x & 1) {
+			// Odd start: the first pixel is the low nibble of its byte.
+			if (read_bits(src, row_bit, 1, progmem)) {
+				*dst = (*dst & 0xF0) | (f & 0x0F);
+			} else if (opaque) {
+				*dst = (*dst & 0xF0) | (b & 0x0F);
+			}
+			dst++;
+			row_bit++;
+			n--;
+		}
+
+		while (n > 0) {
+			uint8_t count = (n < 8) ? n : 8;
+			uint8_t bits = read_bits(src, row_bit, count, progmem);
+			uint16_t hi = pgm_read_word(&expand_nibble[bits >> 4]);
+			uint16_t lo = pgm_read_word(&expand_nibble[bits & 0x0F]);
+			uint8_t mask[4] = {uint8_t(hi >> 8), uint8_t(hi), uint8_t(lo >> 8), uint8_t(lo)};
+			uint8_t bytes = (count + 1) / 2;
+
+			if (!opaque) {
+				for (uint8_t k = 0; k < bytes; k++) {
+					dst[k] = (dst[k] & ~mask[k]) | (f & mask[k]);
+				}
+			} else if (count == 8) {
+				for (uint8_t k = 0; k < 4; k++) {
+					dst[k] = (f & mask[k]) | (b & ~mask[k]);
+				}
+			} else {
+				// Partial last group: only touch the nibbles the bitmap covers.
+				uint8_t cover_bits = 0xFF << (8 - count);
+				uint16_t cover_hi = pgm_read_word(&expand_nibble[cover_bits >> 4]);
+				uint16_t cover_lo = pgm_read_word(&expand_nibble[cover_bits & 0x0F]);
+				uint8_t cover[4] = {uint8_t(cover_hi >> 8), uint8_t(cover_hi), uint8_t(cover_lo >> 8), uint8_t(cover_lo)};
+				for (uint8_t k = 0; k < bytes; k++) {
+					uint8_t v = (f & mask[k]) | (b & ~mask[k]);
+					dst[k] = (dst[k] & ~cover[k]) | (v & cover[k]);
+				}
+			}
+			dst += 4;
+			row_bit += 8;
+			n -= count;
+		}
+	}
+	window_x1 = min(window_x1, x);
+	window_y1 = min(window_y1, y);
+	window_x2 = max(window_x2, int16_t(x + w - 1));
+	window_y2 = max(window_y2, int16_t(y + h - 1));
+	endWrite();
+}
+
+// Expand a 1bpp bitmap into the frame buffer in rotations where its rows
+// don't run left to right along buffer rows. Pixels go one at a time, but
+// straight into their nibbles, stepping through the buffer rather than
+// transforming and clipping each one in drawPixel().
+void Adafruit_SSD1322::blit_1bpp_rotated(int16_t x, int16_t y, const uint8_t *src,
+                                         uint16_t stride, int16_t w, int16_t h,
+                                         bool progmem, uint8_t fg, uint8_t bg, bool opaque)
+{
+	uint32_t bit = 0;
+	if (x < 0) {
+		bit = -x;
+		w += x;
+		x = 0;
+	}
+	if (x + w > width()) {
+		w = width() - x;
+	}
+	if (y < 0) {
+		bit += uint32_t(-y) * stride;
+		h += y;
+		y = 0;
+	}
+	if (y + h > height()) {
+		h = height() - y;
+	}
+	if ((w <= 0) || (h <= 0)) {
+		return;
+	}
+
+	// Frame buffer rectangle covered, which has to overlap the band.
+	int16_t bx = x;
+	int16_t by = y;
+	int16_t bw = w;
+	int16_t bh = h;
+	rotate_rect(bx, by, bw, bh);
+	int16_t by1 = max(by, band_y1);
+	int16_t by2 = min(int16_t(by + bh - 1), band_y2);
+	if (by1 > by2) {
+		return;
+	}
+
+	// Where the bitmap's top left pixel lands, and how the position moves
+	// for each step right (i) and down (j) the bitmap.
+	int16_t x0, y0, xi, yi, xj, yj;
+	switch (buffer_rotation()) {
+	case 1:
+		x0 = WIDTH - 1 - y;
+		y0 = x;
+		xi = 0;
+		yi = 1;
+		xj = -1;
+		yj = 0;
+		break;
+	case 2:
+		x0 = WIDTH - 1 - x;
+		y0 = HEIGHT - 1 - y;
+		xi = -1;
+		yi = 0;
+		xj = 0;
+		yj = -1;
+		break;
+	default:
+		x0 = y;
+		y0 = HEIGHT - 1 - x;
+		xi = 0;
+		yi = -1;
+		xj = 1;
+		yj = 0;
+		break;
+	}
+
+	fg &= 0x0F;
+	bg &= 0x0F;
+	startWrite();
+	for (int16_t j = 0; j < h; j++, bit += stride) {
+		int16_t px = x0 + j * xj;
+		int16_t py = y0 + j * yj;
+		uint32_t row_bit = bit;
+		for (int16_t i = 0; i < w; i++, row_bit++, px += xi, py += yi) {
+			if ((py < band_y1) || (py > band_y2)) {
+				continue;
+			}
+			const uint8_t *p = src + (row_bit >> 3);
+			bool set = (progmem ? pgm_read_byte(p) : *p) & (0x80 >> (row_bit & 7));
+			if (!set && !opaque) {
+				continue;
+			}
+			uint8_t color = set ? fg : bg;
+			uint8_t *ptr = row_ptr(py) + px / 2;
+			if (px & 1) {
+				*ptr = (*ptr & 0xF0) | color;
+			} else {
+				*ptr = (*ptr & 0x0F) | (color << 4);
+			}
+		}
+	}
+	window_x1 = min(window_x1, bx);
+	window_y1 = min(window_y1, by1);
+	window_x2 = max(window_x2, int16_t(bx + bw - 1));
+	window_y2 = max(window_y2, by2);
+	endWrite();
+}
+
+/*!
+    @brief  Draw a PROGMEM-resident 1bpp bitmap. Set bits are drawn in the
+            given color, clear bits are left alone.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  bitmap
+            Bitmap data, rows padded to whole bytes
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                                  int16_t h, uint16_t color)
+{
+	blit_1bpp(x, y, bitmap, ((w + 7) / 8) * 8, w, h, true, color, 0, false);
+}
+
+/*!
+    @brief  Draw a PROGMEM-resident 1bpp bitmap with a background color.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  bitmap
+            Bitmap data, rows padded to whole bytes
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  color
+            Gray level for set bits, 0 to 15
+    @param  bg
+            Gray level for clear bits, 0 to 15
+*/
+void Adafruit_SSD1322::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                                  int16_t h, uint16_t color, uint16_t bg)
+{
+	blit_1bpp(x, y, bitmap, ((w + 7) / 8) * 8, w, h, true, color, bg, true);
+}
+
+/*!
+    @brief  Draw a RAM-resident 1bpp bitmap. Set bits are drawn in the given
+            color, clear bits are left alone.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  bitmap
+            Bitmap data, rows padded to whole bytes
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h,
+                                  uint16_t color)
+{
+	blit_1bpp(x, y, bitmap, ((w + 7) / 8) * 8, w, h, false, color, 0, false);
+}
+
+/*!
+    @brief  Draw a RAM-resident 1bpp bitmap with a background color.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  bitmap
+            Bitmap data, rows padded to whole bytes
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  color
+            Gray level for set bits, 0 to 15
+    @param  bg
+            Gray level for clear bits, 0 to 15
+*/
+void Adafruit_SSD1322::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h,
+                                  uint16_t color, uint16_t bg)
+{
+	blit_1bpp(x, y, bitmap, ((w + 7) / 8) * 8, w, h, false, color, bg, true);
+}
+
+/*!
+    @brief  Print one character. Glyphs from GFX fonts (setFont()) at text
+            size 1 are expanded straight into the frame buffer, in any
+            rotation; everything else goes through Adafruit_GFX::write().
+    @param  c
+            The character
+    @return 1
+*/
+size_t Adafruit_SSD1322::write(uint8_t c)
+{
+	// The built-in 5x7 font is private to Adafruit_GFX, so it can't be blitted here.
+	if (!gfxFont || (textsize_x != 1) || (textsize_y != 1)) {
+		return Adafruit_GrayOLED::write(c);
+	}
+
+	if (c == '\n') {
+		cursor_x = 0;
+		cursor_y += (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+	} else if (c != '\r') {
+		uint8_t first = pgm_read_byte(&gfxFont->first);
+		if ((c >= first) && (c <= (uint8_t)pgm_read_byte(&gfxFont->last))) {
+			GFXglyph *glyph = ((GFXglyph *)pgm_read_pointer(&gfxFont->glyph)) + (c - first);
+			uint8_t w = pgm_read_byte(&glyph->width);
+			uint8_t h = pgm_read_byte(&glyph->height);
+			if ((w > 0) && (h > 0)) {
+				int16_t xo = (int8_t)pgm_read_byte(&glyph->xOffset);
+				int16_t yo = (int8_t)pgm_read_byte(&glyph->yOffset);
+				if (wrap && ((cursor_x + xo + w) > _width)) {
+					cursor_x = 0;
+					cursor_y += (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
+				}
+				// Glyph rows are packed back to back with no padding.
+				uint8_t *bitmap = (uint8_t *)pgm_read_pointer(&gfxFont->bitmap);
+				bitmap += pgm_read_word(&glyph->bitmapOffset);
+				blit_1bpp(cursor_x + xo, cursor_y + yo, bitmap, w, w, h, true, textcolor, 0, false);
+			}
+			cursor_x += (uint8_t)pgm_read_byte(&glyph->xAdvance);
+		}
+	}
+	return 1;
+}
+
+/*!
+    @brief  Draw a whole string starting at the given position, as a single
+            drawing operation (and so a single dirty rectangle). The cursor
+            is left at the end of the string.
+    @param  x
+            Cursor x position to start at
+    @param  y
+            Cursor y position to start at
+    @param  str
+            Zero-terminated string
+*/
+void Adafruit_SSD1322::drawText(int16_t x, int16_t y, const char *str)
+{
+	startWrite();
+	setCursor(x, y);
+	while (*str) {
+		write(*str++);
+	}
+	endWrite();
+}
+
+// GRAYSCALE IMAGES --------------------------------------------------------
+
+// Copy a 4bpp image into the frame buffer, clipped to the display.
+void Adafruit_SSD1322::blit_4bpp(int16_t x, int16_t y, const uint8_t *src, int16_t w,
+                                 int16_t h, bool progmem)
+{
+	uint16_t src_stride = (w + 1) / 2;
+	if (buffer_rotation() != 0) {
+		// Image rows don't run along frame buffer rows; drawPixel() does
+		// the mapping (and the clipping) for each pixel.
+		startWrite();
+		for (int16_t j = 0; j < h; j++, src += src_stride) {
+			for (int16_t i = 0; i < w; i++) {
+				uint8_t v = progmem ? pgm_read_byte(src + i / 2) : src[i / 2];
+				drawPixel(x + i, y + j, (i & 1) ? (v & 0x0F) : (v >> 4));
+			}
+		}
+		endWrite();
+		return;
+	}
+
+	int16_t skip = 0;
+	if (x < 0) {
+		skip = -x;
+		w += x;
+		x = 0;
+	}
+	if (x + w > WIDTH) {
+		w = WIDTH - x;
+	}
+	if (y < band_y1) {
+		src += uint32_t(band_y1 - y) * src_stride;
+		h -= band_y1 - y;
+		y = band_y1;
+	}
+	if (y + h - 1 > band_y2) {
+		h = band_y2 - y + 1;
+	}
+	if ((w <= 0) || (h <= 0)) {
+		return;
+	}
+
+	startWrite();
+	for (int16_t j = 0; j < h; j++, src += src_stride) {
+		uint8_t *dst = row_ptr(y + j);
+		int16_t sx = skip;
+		int16_t dx = x;
+		int16_t n = w;
+
+		if ((dx & 1) == (sx & 1)) {
+			// Same nibble alignment: only the ends need nibble handling.
+			if (dx & 1) {
+				uint8_t v = progmem ? pgm_read_byte(src + sx / 2) : src[sx / 2];
+				dst[dx / 2] = (dst[dx / 2] & 0xF0) | (v & 0x0F);
+				sx++;
+				dx++;
+				n--;
+			}
+			if (n >= 2) {
+				if (progmem) {
+					memcpy_P(dst + dx / 2, src + sx / 2, n / 2);
+				} else {
+					memcpy(dst + dx / 2, src + sx / 2, n / 2);
+				}
+			}
+			if (n & 1) {
+				sx += n - 1;
+				dx += n - 1;
+				uint8_t v = progmem ? pgm_read_byte(src + sx / 2) : src[sx / 2];
+				dst[dx / 2] = (dst[dx / 2] & 0x0F) | (v & 0xF0);
+			}
+		} else {
+			// Opposite alignment: every pixel moves to the other nibble.
+			for (; n > 0; n--, sx++, dx++) {
+				uint8_t v = progmem ? pgm_read_byte(src + sx / 2) : src[sx / 2];
+				v = (sx & 1) ? (v & 0x0F) : (v >> 4);
+				if (dx & 1) {
+					dst[dx / 2] = (dst[dx / 2] & 0xF0) | v;
+				} else {
+					dst[dx / 2] = (dst[dx / 2] & 0x0F) | (v << 4);
+				}
+			}
+		}
+	}
+	window_x1 = min(window_x1, x);
+	window_y1 = min(window_y1, y);
+	window_x2 = max(window_x2, int16_t(x + w - 1));
+	window_y2 = max(window_y2, int16_t(y + h - 1));
+	endWrite();
+}
+
+// Linear mapping from 8-bit luminance to gray levels in 1/16ths (0-240),
+// used until setLuminanceGamma() builds a different one.
+static const uint8_t PROGMEM linear_luminance[256] = {
+    0,   1,   2,   3,   4,   5,   6,   7,   8,   8,   9,   10,  11,  12,  13,  14,
+    15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  24,  25,  26,  27,  28,  29,
+    30,  31,  32,  33,  34,  35,  36,  37,  38,  39,  40,  40,  41,  42,  43,  44,
+    45,  46,  47,  48,  49,  50,  51,  52,  53,  54,  55,  56,  56,  57,  58,  59,
+    60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,  72,  72,  73,  74,
+    75,  76,  77,  78,  79,  80,  81,  82,  83,  84,  85,  86,  87,  88,  88,  89,
+    90,  91,  92,  93,  94,  95,  96,  97,  98,  99,  100, 101, 102, 103, 104, 104,
+    105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120,
+    120, 121, 122, 123, 124, 125, 126, 127, 128, 129, 130, 131, 132, 133, 134, 135,
+    136, 136, 137, 138, 139, 140, 141, 142, 143, 144, 145, 146, 147, 148, 149, 150,
+    151, 152, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165,
+    166, 167, 168, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177, 178, 179, 180,
+    181, 182, 183, 184, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 194, 195,
+    196, 197, 198, 199, 200, 200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210,
+    211, 212, 213, 214, 215, 216, 216, 217, 218, 219, 220, 221, 222, 223, 224, 225,
+    226, 227, 228, 229, 230, 231, 232, 232, 233, 234, 235, 236, 237, 238, 239, 240};
+
+// 4x4 ordered dither thresholds
+static const uint8_t PROGMEM bayer4[4][4] = {
+    {0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+// Gray level for an 8-bit luminance drawn at (x, y).
+uint8_t Adafruit_SSD1322::gray_level(uint8_t v, int16_t x, int16_t y, bool dither)
+{
+	// Gray level in 1/16ths.
+	uint8_t f = luminance_lut ? luminance_lut[v] : pgm_read_byte(&linear_luminance[v]);
+	if (dither) {
+		// The fraction is compared against the threshold for this pixel.
+		return (f + pgm_read_byte(&bayer4[y & 3][x & 3])) >> 4;
+	}
+	return (f + 8) >> 4;
+}
+
+// Convert an 8bpp image into the frame buffer, clipped to the display.
+void Adafruit_SSD1322::blit_8bpp(int16_t x, int16_t y, const uint8_t *src, int16_t w,
+                                 int16_t h, bool progmem, bool dither)
+{
+	uint16_t src_stride = w;
+	if (buffer_rotation() != 0) {
+		// As in blit_4bpp(), with the dither pattern following the image.
+		startWrite();
+		for (int16_t j = 0; j < h; j++, src += src_stride) {
+			for (int16_t i = 0; i < w; i++) {
+				uint8_t v = progmem ? pgm_read_byte(src + i) : src[i];
+				drawPixel(x + i, y + j, gray_level(v, x + i, y + j, dither));
+			}
+		}
+		endWrite();
+		return;
+	}
+
+	if (x < 0) {
+		src -= x;
+		w += x;
+		x = 0;
+	}
+	if (x + w > WIDTH) {
+		w = WIDTH - x;
+	}
+	if (y < band_y1) {
+		src += uint32_t(band_y1 - y) * src_stride;
+		h -= band_y1 - y;
+		y = band_y1;
+	}
+	if (y + h - 1 > band_y2) {
+		h = band_y2 - y + 1;
+	}
+	if ((w <= 0) || (h <= 0)) {
+		return;
+	}
+
+	startWrite();
+	for (int16_t j = 0; j < h; j++, src += src_stride) {
+		uint8_t *dst = row_ptr(y + j);
+		for (int16_t i = 0; i < w; i++) {
+			uint8_t v = progmem ? pgm_read_byte(src + i) : src[i];
+			int16_t dx = x + i;
+			uint8_t level = gray_level(v, dx, y + j, dither);
+			if (dx & 1) {
+				dst[dx / 2] = (dst[dx / 2] & 0xF0) | level;
+			} else {
+				dst[dx / 2] = (dst[dx / 2] & 0x0F) | (level << 4);
+			}
+		}
+	}
+	window_x1 = min(window_x1, x);
+	window_y1 = min(window_y1, y);
+	window_x2 = max(window_x2, int16_t(x + w - 1));
+	window_y2 = max(window_y2, int16_t(y + h - 1));
+	endWrite();
+}
+
+/*!
+    @brief  Draw a PROGMEM-resident 4bpp grayscale image. Rows are copied
+            into the frame buffer with memcpy_P() wherever the image and
+            the buffer have the same nibble alignment.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  bitmap
+            Image data, two pixels per byte with the left pixel in the high
+            nibble, rows padded to a whole byte
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @note   In rotations where the image rows don't line up with frame
+            buffer rows, the image is drawn a pixel at a time instead.
+*/
+void Adafruit_SSD1322::drawGrayBitmap4(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                                       int16_t h)
+{
+	blit_4bpp(x, y, bitmap, w, h, true);
+}
+
+/*!
+    @brief  Draw a RAM-resident 4bpp grayscale image.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  bitmap
+            Image data, two pixels per byte with the left pixel in the high
+            nibble, rows padded to a whole byte
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+*/
+void Adafruit_SSD1322::drawGrayBitmap4(int16_t x, int16_t y, uint8_t *bitmap, int16_t w,
+                                       int16_t h)
+{
+	blit_4bpp(x, y, bitmap, w, h, false);
+}
+
+/*!
+    @brief  Draw a PROGMEM-resident 8bpp grayscale image, reduced to the 16
+            gray levels of the display.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  bitmap
+            Image data, one byte per pixel, 0 = black, 255 = white
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  dither
+            If true, use a 4x4 ordered dither instead of rounding to the
+            nearest level, to hide banding in smooth gradients.
+    @note   As with drawGrayBitmap4(), rotations that turn the image
+            across the frame buffer rows are drawn a pixel at a time.
+*/
+void Adafruit_SSD1322::drawGrayBitmap8(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                                       int16_t h, bool dither)
+{
+	blit_8bpp(x, y, bitmap, w, h, true, dither);
+}
+
+/*!
+    @brief  Draw a RAM-resident 8bpp grayscale image, reduced to the 16 gray
+            levels of the display.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  bitmap
+            Image data, one byte per pixel, 0 = black, 255 = white
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  dither
+            If true, use a 4x4 ordered dither instead of rounding to the
+            nearest level.
+*/
+void Adafruit_SSD1322::drawGrayBitmap8(int16_t x, int16_t y, uint8_t *bitmap, int16_t w,
+                                       int16_t h, bool dither)
+{
+	blit_8bpp(x, y, bitmap, w, h, false, dither);
+}
+
+// Reader for streamGrayBitmap4(); the context is a pointer to the next PROGMEM byte.
+static size_t read_progmem(uint8_t *data, size_t count, void *context)
+{
+	const uint8_t **ptr = (const uint8_t **)context;
+	memcpy_P(data, *ptr, count);
+	*ptr += count;
+	return count;
+}
+
+/*!
+    @brief  Send a PROGMEM-resident 4bpp image straight to display RAM,
+            without going through the frame buffer.
+    @param  x
+            Left edge. Must be a multiple of 4.
+    @param  y
+            Top edge
+    @param  bitmap
+            Image data in the same format as drawGrayBitmap4()
+    @param  w
+            Width in pixels. Must be a multiple of 4.
+    @param  h
+            Height in pixels
+    @return true if the image was sent, false if it doesn't fit on the
+            display, isn't aligned to the controller's 4-pixel columns or
+            the display is rotated; see streamGrayImage4().
+    @note   The frame buffer is not changed, so a later display() will
+            draw over the image wherever the buffer is dirty.
+*/
+bool Adafruit_SSD1322::streamGrayBitmap4(int16_t x, int16_t y, const uint8_t bitmap[],
+                                         int16_t w, int16_t h)
+{
+	const uint8_t *ptr = bitmap;
+	return streamGrayImage4(x, y, w, h, read_progmem, &ptr);
+}
+
+/*!
+    @brief  Send a 4bpp image from any source (e.g. a file) straight to
+            display RAM, a small chunk at a time, without going through the
+            frame buffer.
+    @param  x
+            Left edge. Must be a multiple of 4.
+    @param  y
+            Top edge
+    @param  w
+            Width in pixels. Must be a multiple of 4.
+    @param  h
+            Height in pixels
+    @param  read
+            Called to fetch the next count bytes of image data into data.
+            Must return the number of bytes read; anything short of count
+            stops the transfer.
+    @param  context
+            Passed through to read.
+    @return true if the whole image was sent. false if it doesn't fit or
+            isn't aligned, or if the display is rotated: the image goes to
+            display RAM as it is, so it can only be drawn in rotation 0, or
+            in rotation 2 when setHardwareFlip() has the controller turn
+            the picture round.
+    @note   The frame buffer is not changed, so a later display() will
+            draw over the image wherever the buffer is dirty. Sending the
+            image counts as an update, for getStats() and for waking the
+            panel from setIdleTimeouts().
+*/
+bool Adafruit_SSD1322::streamGrayImage4(int16_t x, int16_t y, int16_t w, int16_t h,
+                                        size_t (*read)(uint8_t *data, size_t count,
+                                                       void *context),
+                                        void *context)
+{
+	if ((x < 0) || (y < 0) || (w <= 0) || (h <= 0) ||
+		(x + w > WIDTH) || (y + h > HEIGHT) ||
+		(x & 3) || (w & 3) || buffer_rotation()) {
+		return false;
+	}
+
+	// Anything already queued has to go out first.
+	waitForDisplay();
+
+	uint8_t chunk[32];
+	uint16_t bytes_per_row = WIDTH / 2;
+	uint16_t start_column = x / 4;
+	uint16_t end_column = (x + w) / 4 - 1;
+	uint16_t end_row = y + h - 1;
+	bool ok = true;
+
+	begin_batch();
+	frame_begin();
+	for (uint16_t first_row = y; ok && (first_row <= end_row); )
+	{
+		uint16_t last_row = start_write(start_column, first_row, end_column, end_row);
+		for (uint16_t row = first_row; ok && (row <= last_row); row++) {
+			continue_write(start_column, row);
+			uint8_t *sptr = shadow ? shadow + row * bytes_per_row + x / 2 : NULL;
+			for (uint16_t sent = 0; sent < w / 2; ) {
+				size_t count = min(sizeof(chunk), size_t(w / 2 - sent));
+				if (read(chunk, count, context) != count) {
+					ok = false;
+					break;
+				}
+				spi_data(chunk, count);
+				// Keep the shadow buffer in step with display RAM.
+				if (sptr) {
+					memcpy(sptr + sent, chunk, count);
+				}
+				sent += count;
+			}
+		}
+		first_row = last_row + 1;
+	}
+	frame_end();
+	end_batch();
+	return ok;
+}
+
+// COMPRESSED IMAGES -------------------------------------------------------
+
+// Token ranges in the RLE image format; see drawRLEImage().
+#define RLE_SHORT_RUN 0x00 // 0LLLGGGG: L+1 (1-8) pixels of gray G
+#define RLE_LITERAL 0x80   // 10NNNNNN: N+1 pixels follow, packed two per byte
+#define RLE_LONG_RUN 0xC0  // 1100GGGG nnnnnnnn: n+9 (9-264) pixels of gray G
+#define RLE_SKIP 0xD0      // 0xD0-0xFE: 1-47 pixels left unchanged
+#define RLE_LONG_SKIP 0xFF // 0xFF, then a 16-bit count of pixels left unchanged
+
+static uint16_t read16(const uint8_t *ptr)
+{
+	return pgm_read_byte(ptr) | (uint16_t(pgm_read_byte(ptr + 1)) << 8);
+}
+
+// Find the tokens for one frame of an RLE image, or NULL if there's no such frame.
+static const uint8_t *rle_frame(const uint8_t image[], uint16_t frame, uint16_t &length)
+{
+	if (frame >= read16(image + 4)) {
+		return NULL;
+	}
+	const uint8_t *ptr = image + 6;
+	for (;;) {
+		length = read16(ptr);
+		ptr += 2;
+		if (frame-- == 0) {
+			return ptr;
+		}
+		ptr += length;
+	}
+}
+
+// Walks the tokens of one frame of an RLE image.
+struct rle_decoder {
+	const uint8_t *ptr;
+	const uint8_t *end;
+	uint8_t kind;   // RLE_SHORT_RUN (for both kinds of run), RLE_LITERAL or RLE_SKIP
+	uint8_t gray;   // gray level of a run
+	uint16_t count; // pixels left in the current token
+	bool high;      // the next literal pixel is in the high nibble
+
+	// Read the next token. Returns false at the end of the frame.
+	bool next() {
+		if (ptr >= end) {
+			return false;
+		}
+		uint8_t token = pgm_read_byte(ptr++);
+		if (token < RLE_LITERAL) {
+			kind = RLE_SHORT_RUN;
+			count = (token >> 4) + 1;
+			gray = token & 0x0F;
+		} else if (token < RLE_LONG_RUN) {
+			kind = RLE_LITERAL;
+			count = (token & 0x3F) + 1;
+			high = true;
+		} else if (token < RLE_SKIP) {
+			kind = RLE_SHORT_RUN;
+			count = pgm_read_byte(ptr++) + 9;
+			gray = token & 0x0F;
+		} else if (token < RLE_LONG_SKIP) {
+			kind = RLE_SKIP;
+			count = token - RLE_SKIP + 1;
+		} else {
+			kind = RLE_SKIP;
+			count = read16(ptr);
+			ptr += 2;
+		}
+		return true;
+	}
+
+	// Take the next pixel of a literal.
+	uint8_t literal() {
+		uint8_t b = pgm_read_byte(ptr);
+		count--;
+		if (high) {
+			high = false;
+			if (count == 0) {
+				ptr++;
+			}
+			return b >> 4;
+		}
+		high = true;
+		ptr++;
+		return b & 0x0F;
+	}
+};
+
+/*!
+    @brief  Number of frames in an RLE image.
+    @param  image
+            RLE image data in PROGMEM
+    @return The frame count
+*/
+uint16_t Adafruit_SSD1322::getRLEFrames(const uint8_t image[])
+{
+	return read16(image + 4);
+}
+
+/*!
+    @brief  Decode one frame of a run-length compressed 4bpp image or
+            animation into the frame buffer.
+
+            The data (all 16-bit numbers little-endian) is the width,
+            height and number of frames, then for each frame its length in
+            bytes followed by tokens covering its pixels left to right, top
+            to bottom:
+              - 0LLLGGGG: a run of L+1 pixels of gray level G
+              - 10NNNNNN: N+1 literal pixels follow, two per byte, left
+                pixel in the high nibble
+              - 1100GGGG, then a byte n: a run of n+9 pixels of gray G
+              - 0xD0 to 0xFE: skip over 1 to 47 pixels
+              - 0xFF, then a 16-bit count: skip over that many pixels
+            Skipped pixels are left as they are, so later frames of an
+            animation only need to describe what changed from the frame
+            before (and skips also serve as transparency).
+            tools/rle_encode.py makes these from PGM images.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  image
+            RLE image data in PROGMEM
+    @param  frame
+            Frame number, starting at 0. Frames after the first are
+            normally drawn over the one before, in order.
+    @return true if the whole frame was decoded, false if there's no such
+            frame or its data runs out early.
+*/
+bool Adafruit_SSD1322::drawRLEImage(int16_t x, int16_t y, const uint8_t image[],
+                                    uint16_t frame)
+{
+	uint16_t length;
+	const uint8_t *tokens = rle_frame(image, frame, length);
+	if (!tokens) {
+		return false;
+	}
+	int16_t w = read16(image);
+	int16_t h = read16(image + 2);
+	rle_decoder dec = {tokens, tokens + length, 0, 0, 0, false};
+
+	// Other rotations go through the GFX primitives, which take care of the transform.
+	bool direct = (buffer_rotation() == 0);
+
+	startWrite();
+	int16_t col = 0;
+	int16_t row = 0;
+	while (row < h) {
+		if ((dec.count == 0) && !dec.next()) {
+			break;
+		}
+		int16_t n = min(dec.count, uint16_t(w - col));
+		int16_t px = x + col;
+		int16_t py = y + row;
+		int16_t x1 = max(px, int16_t(0));
+		int16_t x2 = min(int16_t(px + n - 1), int16_t(WIDTH - 1));
+		uint8_t *dst = (direct && (py >= band_y1) && (py <= band_y2) && (x1 <= x2)) ? row_ptr(py) : NULL;
+
+		if (dec.kind == RLE_SKIP) {
+			dec.count -= n;
+		} else if (dec.kind == RLE_SHORT_RUN) {
+			dec.count -= n;
+			if (dst) {
+				fill_span(dst, x1, x2, dec.gray);
+			} else if (!direct) {
+				drawFastHLine(px, py, n, dec.gray);
+			}
+		} else {
+			for (int16_t i = 0; i < n; ) {
+				int16_t dx = px + i;
+				if (dst && dec.high && !(dx & 1) && (n - i >= 2) && (dx >= 0) && (dx + 1 < WIDTH)) {
+					// A whole byte of the literal lines up with a byte of the buffer.
+					dst[dx / 2] = pgm_read_byte(dec.ptr++);
+					dec.count -= 2;
+					i += 2;
+					continue;
+				}
+				uint8_t gray = dec.literal();
+				if (dst && (dx >= x1) && (dx <= x2)) {
+					uint8_t *ptr = dst + dx / 2;
+					if (dx & 1) {
+						*ptr = (*ptr & 0xF0) | gray;
+					} else {
+						*ptr = (*ptr & 0x0F) | (gray << 4);
+					}
+				} else if (!direct) {
+					drawPixel(dx, py, gray);
+				}
+				i++;
+			}
+		}
+		if (dst && (dec.kind != RLE_SKIP)) {
+			window_x1 = min(window_x1, x1);
+			window_y1 = min(window_y1, py);
+			window_x2 = max(window_x2, x2);
+			window_y2 = max(window_y2, py);
+		}
+
+		col += n;
+		if (col >= w) {
+			col = 0;
+			row++;
+		}
+	}
+	endWrite();
+	return row >= h;
+}
+
+// Reader for streamRLEImage(); the context is an rle_decoder.
+static size_t read_rle(uint8_t *data, size_t count, void *context)
+{
+	rle_decoder *dec = (rle_decoder *)context;
+	for (size_t i = 0; i < count; i++) {
+		uint8_t pair = 0;
+		for (uint8_t half = 0; half < 2; half++) {
+			while (dec->count == 0) {
+				if (!dec->next()) {
+					return i;
+				}
+			}
+			if (dec->kind == RLE_SHORT_RUN) {
+				pair = (pair << 4) | dec->gray;
+				dec->count--;
+			} else if (dec->kind == RLE_LITERAL) {
+				pair = (pair << 4) | dec->literal();
+			} else {
+				// Display RAM can't be skipped over mid-stream.
+				return i;
+			}
+		}
+		data[i] = pair;
+	}
+	return count;
+}
+
+/*!
+    @brief  Decode one frame of an RLE image straight to display RAM, a
+            few bytes at a time, without going through the frame buffer.
+    @param  x
+            Left edge. Must be a multiple of 4.
+    @param  y
+            Top edge
+    @param  image
+            RLE image data in PROGMEM. Its width must be a multiple of 4.
+    @param  frame
+            Frame number, starting at 0. The frame must not skip any
+            pixels, so this is normally only useful for the first frame.
+    @return true if the whole frame was sent.
+    @note   As with streamGrayImage4(), the frame buffer is not changed.
+*/
+bool Adafruit_SSD1322::streamRLEImage(int16_t x, int16_t y, const uint8_t image[],
+                                      uint16_t frame)
+{
+	uint16_t length;
+	const uint8_t *tokens = rle_frame(image, frame, length);
+	if (!tokens) {
+		return false;
+	}
+	rle_decoder dec = {tokens, tokens + length, 0, 0, 0, false};
+	return streamGrayImage4(x, y, read16(image), read16(image + 2), read_rle, &dec);
+}
+
+// DIRTY RECTANGLE TRACKING ------------------------------------------------
+
+/*!
+    @brief  Begin a GFX drawing operation. Nested calls are counted so that
+            only the outermost startWrite()/endWrite() pair closes off a
+            dirty rectangle.
+*/
+void Adafruit_SSD1322::startWrite(void) {
+	write_depth++;
+}
+
+/*!
+    @brief  End a GFX drawing operation. When the outermost operation ends,
+            the area it touched is moved from the superclass' dirty window
+            into the dirty rectangle list.
+*/
+void Adafruit_SSD1322::endWrite(void) {
+	if (write_depth > 0) {
+		write_depth--;
+	}
+	if (write_depth == 0) {
+		fold_window();
+	}
+}
+
+void Adafruit_SSD1322::reset_window()
+{
+	window_x1 = 1024;
+	window_y1 = 1024;
+	window_x2 = -1;
+	window_y2 = -1;
+}
+
+// Move the superclass' dirty window (clipped to the display) into the dirty rectangle list.
+void Adafruit_SSD1322::fold_window()
+{
+	if ((window_x1 <= window_x2) && (window_y1 <= window_y2)) {
+		dirty_rect r;
+		r.x1 = max(int16_t(0), int16_t(window_x1));
+		r.y1 = max(band_y1, int16_t(window_y1));
+		r.x2 = min(int16_t(WIDTH - 1), int16_t(window_x2));
+		r.y2 = min(band_y2, int16_t(window_y2));
+		if ((r.x1 <= r.x2) && (r.y1 <= r.y2)) {
+			add_dirty(r);
+		}
+	}
+	reset_window();
+}
+
+// Estimated time (ns) to flush a rectangle on its own.
+uint32_t Adafruit_SSD1322::dirty_cost(const dirty_rect &r)
+{
+	int16_t start_column, end_column;
+	uint16_t rows = r.y2 - r.y1 + 1;
+	window_columns(r.x1, r.x2, rows, start_column, end_column);
+	return write_cost(end_column - start_column + 1, rows);
+}
+
+static void merge_rect(int16_t &x1, int16_t &y1, int16_t &x2, int16_t &y2,
+                       int16_t ox1, int16_t oy1, int16_t ox2, int16_t oy2)
+{
+	x1 = min(x1, ox1);
+	y1 = min(y1, oy1);
+	x2 = max(x2, ox2);
+	y2 = max(y2, oy2);
+}
+
+/*!
+    @brief  Add a rectangle to the dirty list, merging it with existing
+            entries wherever flushing the union would be no more expensive
+            than flushing the pieces separately.
+*/
+void Adafruit_SSD1322::add_dirty(dirty_rect r)
+{
+	// Absorb every existing rectangle that is cheaper to send together with this one.
+	bool merged;
+	do {
+		merged = false;
+		for (uint8_t i = 0; i < dirty_count; i++) {
+			dirty_rect u = r;
+			merge_rect(u.x1, u.y1, u.x2, u.y2, dirty[i].x1, dirty[i].y1, dirty[i].x2, dirty[i].y2);
+			if (dirty_cost(u) <= dirty_cost(r) + dirty_cost(dirty[i])) {
+				r = u;
+				dirty[i] = dirty[--dirty_count];
+				merged = true;
+				break;
+			}
+		}
+	} while (merged);
+
+	if (dirty_count < SSD1322_MAX_DIRTY_RECTS) {
+		dirty[dirty_count++] = r;
+		return;
+	}
+
+	// The list is full. Find the merge that adds the fewest bytes, either the
+	// new rectangle with an existing one or two existing ones with each other.
+	uint8_t best_i = 0, best_j = 0xFF;
+	uint32_t best_penalty = 0xFFFFFFFF;
+	for (uint8_t i = 0; i < dirty_count; i++) {
+		dirty_rect u = r;
+		merge_rect(u.x1, u.y1, u.x2, u.y2, dirty[i].x1, dirty[i].y1, dirty[i].x2, dirty[i].y2);
+		uint32_t penalty = dirty_cost(u) - dirty_cost(r) - dirty_cost(dirty[i]);
+		if (penalty < best_penalty) {
+			best_penalty = penalty;
+			best_i = i;
+			best_j = 0xFF;
+		}
+		for (uint8_t j = i + 1; j < dirty_count; j++) {
+			u = dirty[i];
+			merge_rect(u.x1, u.y1, u.x2, u.y2, dirty[j].x1, dirty[j].y1, dirty[j].x2, dirty[j].y2);
+			penalty = dirty_cost(u) - dirty_cost(dirty[i]) - dirty_cost(dirty[j]);
+			if (penalty < best_penalty) {
+				best_penalty = penalty;
+				best_i = i;
+				best_j = j;
+			}
+		}
+	}
+
+	dirty_rect u = dirty[best_i];
+	if (best_j == 0xFF) {
+		// Merge the new rectangle into an existing one.
+		merge_rect(u.x1, u.y1, u.x2, u.y2, r.x1, r.y1, r.x2, r.y2);
+		dirty[best_i] = dirty[--dirty_count];
+	} else {
+		// Merge two existing rectangles and keep the new one as-is.
+		merge_rect(u.x1, u.y1, u.x2, u.y2, dirty[best_j].x1, dirty[best_j].y1, dirty[best_j].x2, dirty[best_j].y2);
+		dirty[best_i] = r;
+		dirty[best_j] = dirty[--dirty_count];
+	}
+	// The merged rectangle may now overlap others, so re-add it from the top.
+	add_dirty(u);
+}
+
+/*!
+    @brief  Do the actual writing of the internal frame buffer to display RAM
+*/
+void Adafruit_SSD1322::display(void) {
+	// ESP8266 needs a periodic yield() call to avoid watchdog reset.
+	// With the limited size of SSD1322 displays, and the fast bitrate
+	// being used (1 MHz or more), I think one yield() immediately before
+	// a screen write and one immediately after should cover it.  But if
+	// not, if this becomes a problem, yields() might be added in the
+	// 32-byte transfer condition below.
+	yield();
+
+	if (!begin_frame()) {
+		return;
+	}
+
+	// Everything for this frame goes out in one transaction.
+	begin_batch();
+	for (uint8_t i = 0; i < dirty_count; i++) {
+		flush_rect(i);
+	}
+	end_frame();
+	end_batch();
+
+	// Updates too short for micros() to time well would only add noise.
+	if (stats && (stats->micros >= 1000)) {
+		refine_costs();
+	}
+}
+
+// Get the dirty rectangle list ready to send. Returns false if there's nothing to send.
+// With timed false it doesn't wait for the panel's scan, even with enableVsync().
+bool Adafruit_SSD1322::begin_frame(bool timed)
+{
+	// Any asynchronous update has to land before this one.
+	waitForDisplay();
+
+	// Pick up anything drawn outside of a startWrite()/endWrite() pair.
+	fold_window();
+
+	check_pixel_shift();
+	// In band mode the buffer only holds part of the frame; renderBands()
+	// sends it, so here there is only the idle time to check.
+	if (band_rows) {
+		dirty_count = 0;
+		check_idle();
+		return false;
+	}
+	if ((dirty_count == 0) && !start_line_pending) {
+		check_idle();
+		return false;
+	}
+	if (!pace_frame()) {
+		return false;
+	}
+	if (vsync && timed) {
+		wait_for_scan();
+	}
+	frame_begin();
+	return true;
+}
+
+// Send one rectangle from the dirty list. Must be inside a batch.
+void Adafruit_SSD1322::flush_rect(uint8_t i)
+{
+	if (shadow_valid) {
+		diff_window(dirty[i].x1, dirty[i].y1, dirty[i].x2, dirty[i].y2);
+	} else {
+		flush_window(dirty[i].x1, dirty[i].y1, dirty[i].x2, dirty[i].y2);
+	}
+}
+
+// Finish off a frame once all of its rectangles are sent. Must be inside a batch.
+void Adafruit_SSD1322::end_frame()
+{
+	// Rows exposed by scrollVertical() are in place, so the panel can move now.
+	if (start_line_pending) {
+		send_start_line();
+	}
+	dirty_count = 0;
+
+	// The whole screen was marked dirty when the shadow buffer was enabled,
+	// so after the first flush it matches display RAM everywhere.
+	if (shadow) {
+		shadow_valid = true;
+	}
+	frame_end();
+}
+
+// Pick the controller columns (4-pixel units) to write for a dirty span of
+// pixels, rows tall.
+void Adafruit_SSD1322::window_columns(int16_t x1, int16_t x2, uint16_t rows, int16_t &start_column, int16_t &end_column)
+{
+	// Column addresses seem to be in 2-byte (4-pixel) units.
+	start_column = x1 / 4;
+	end_column = x2 / 4;
+
+	// A full-width window is addressed once and then written as one run,
+	// where a narrower one on the SH1122 has to be re-addressed every row.
+	// Widen the window when the saved addressing outweighs the extra bytes.
+	uint16_t full = WIDTH / 4;
+	if (write_cost(full, rows) < write_cost(end_column - start_column + 1, rows)) {
+		start_column = 0;
+		end_column = full - 1;
+	}
+}
+
+// Write one rectangle of the frame buffer (in pixel coordinates, inclusive) to display RAM.
+void Adafruit_SSD1322::flush_window(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+	int16_t start_column, end_column;
+	window_columns(x1, x2, y2 - y1 + 1, start_column, end_column);
+	write_window(start_column, y1, end_column, y2);
+}
+
+// Estimated time (ns) to address display RAM for a new window, or on the
+// SH1122 for each row of one.
+uint32_t Adafruit_SSD1322::address_cost()
+{
+	if (is_ssd1322()) {
+		// SETCOLUMN + 2, SETROW + 2, WRITERAM
+		return 3 * cost_command + 7 * cost_byte;
+	}
+	// Two column address commands, SETROW + 1
+	return 2 * cost_command + 4 * cost_byte;
+}
+
+// Estimated time (ns) to write a window of columns (4-pixel units) by rows.
+uint32_t Adafruit_SSD1322::write_cost(uint16_t columns, uint16_t rows)
+{
+	uint32_t data = uint32_t(columns) * 2 * rows * cost_byte;
+	if (is_sh1122() && (columns != WIDTH / 4)) {
+		return rows * address_cost() + data;
+	}
+	return address_cost() + data;
+}
+
+// Measure the bus costs used by the flush strategy, by timing a write of the
+// (cleared) buffer to display RAM and a run of harmless commands.
+void Adafruit_SSD1322::calibrate_costs()
+{
+	uint16_t rows = band_y2 - band_y1 + 1;
+	uint32_t bytes = uint32_t(rows) * (WIDTH / 2);
+
+	uint32_t start = micros();
+	begin_batch();
+	write_window(0, band_y1, WIDTH / 4 - 1, band_y2);
+	end_batch();
+	uint32_t data_us = micros() - start;
+
+	start = micros();
+	begin_batch();
+	for (uint8_t i = 0; i < 32; i++) {
+		spi_command(SSD1322_NORMALDISPLAY);
+	}
+	end_batch();
+	uint32_t command_us = micros() - start;
+
+	cost_byte = max(data_us * 1000 / bytes, uint32_t(1));
+	uint32_t per_command = command_us * 1000 / 32;
+	cost_command = (per_command > cost_byte) ? per_command - cost_byte : 1;
+}
+
+// Nudge the bus costs towards what the last display() actually took, so the
+// estimates follow changes to the bitrate or interrupt load.
+void Adafruit_SSD1322::refine_costs()
+{
+	float predicted = float(stats->commands) * cost_command + float(stats->bytes) * cost_byte;
+	if (predicted <= 0) {
+		return;
+	}
+	float ratio = stats->micros * 1000.0f / predicted;
+	// Move 1/8 of the way each frame, as with the frame rate average.
+	ratio = 1.0f + (ratio - 1.0f) / 8;
+	// Rounded, and kept at 1 or more: a cost that reached 0 would stay there
+	// whatever the timings said, and cost_byte is a divisor.
+	cost_byte = max(uint32_t(cost_byte * ratio + 0.5f), uint32_t(1));
+	cost_command = max(uint32_t(cost_command * ratio + 0.5f), uint32_t(1));
+}
+
+/*!
+    @brief  Write only the parts of a dirty rectangle that differ from what
+            the shadow buffer says is already in display RAM.
+*/
+void Adafruit_SSD1322::diff_window(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+	uint16_t bytes_per_row = WIDTH / 2;
+	int16_t start_column = x1 / 4;
+	int16_t end_column = x2 / 4;
+	// A gap of unchanged columns narrower than this is cheaper to resend than to skip.
+	uint32_t max_gap = address_cost() / (2 * cost_byte);
+
+	// Changed runs that repeat on consecutive rows are collected into one window.
+	int16_t pending_c1 = -1, pending_c2 = -1, pending_r1 = -1, pending_r2 = -1;
+
+	// Rows go out in the order the panel scans them; see wait_for_scan().
+	bool reverse = vsync && flipped;
+	for (int16_t i = y1; i <= y2; i++) {
+		int16_t row = reverse ? y2 - (i - y1) : i;
+		uint8_t *ptr = row_ptr(row);
+		uint8_t *sptr = shadow + row * bytes_per_row;
+		int16_t column = start_column;
+
+		while (column <= end_column) {
+			// Find the start of the next changed run.
+			while ((column <= end_column) &&
+				(ptr[column * 2] == sptr[column * 2]) &&
+				(ptr[column * 2 + 1] == sptr[column * 2 + 1])) {
+				column++;
+			}
+			if (column > end_column) {
+				break;
+			}
+			int16_t run_start = column;
+			int16_t run_end = column;
+
+			// Extend it across changed columns and across gaps too small to be worth a new window.
+			uint32_t gap = 0;
+			for (column++; column <= end_column; column++) {
+				if ((ptr[column * 2] != sptr[column * 2]) ||
+					(ptr[column * 2 + 1] != sptr[column * 2 + 1])) {
+					run_end = column;
+					gap = 0;
+				} else if (++gap > max_gap) {
+					break;
+				}
+			}
+			column = run_end + 1;
+
+			if ((run_start == pending_c1) && (run_end == pending_c2) && reverse && (row == pending_r1 - 1)) {
+				pending_r1 = row;
+			} else if ((run_start == pending_c1) && (run_end == pending_c2) && !reverse && (row == pending_r2 + 1)) {
+				pending_r2 = row;
+			} else {
+				if (pending_r1 >= 0) {
+					write_window(pending_c1, pending_r1, pending_c2, pending_r2);
+				}
+				pending_c1 = run_start;
+				pending_c2 = run_end;
+				pending_r1 = pending_r2 = row;
+			}
+		}
+	}
+
+	if (pending_r1 >= 0) {
+		write_window(pending_c1, pending_r1, pending_c2, pending_r2);
+	}
+}
+
+// Write a window of the frame buffer to display RAM. Columns are in the controller's
+// 4-pixel units, and both ends of each range are inclusive.
+void Adafruit_SSD1322::write_window(uint16_t start_column, uint16_t start_row, uint16_t end_column, uint16_t end_row)
+{
+	uint8_t *ptr;
+	uint16_t bytes_per_row = WIDTH / 2;
+
+	// Need to write two bytes for every column.
+	size_t bytes = (end_column - start_column + 1) * 2;
+
+	if (vsync && flipped) {
+		// The panel scans display RAM from the bottom up, so follow it one
+		// row at a time; see wait_for_scan().
+		for (int16_t row = end_row; row >= int16_t(start_row); row--) {
+			start_write(start_column, row, end_column, row);
+			continue_write(start_column, row);
+			spi_data_runs(row_ptr(row) + start_column * 2, bytes);
+		}
+	} else {
+		// One pass per piece of the window on either side of the display RAM wrap.
+		for (uint16_t first_row = start_row; first_row <= end_row; )
+		{
+			uint16_t last_row = start_write(start_column, first_row, end_column, end_row);
+
+			if (bytes == bytes_per_row)
+			{
+				// Contiguous write case -- just write the entire buffer
+				continue_write(start_column, first_row);
+				ptr = row_ptr(first_row);
+				ptr += (start_column * 2);
+				// Write the entire buffer in one go.
+				spi_data_runs(ptr, bytes * (last_row - first_row + 1));
+			}
+			else
+			{
+				for (uint16_t row = first_row; row <= last_row; row++) 
+				{
+					continue_write(start_column, row);
+					ptr = row_ptr(row);
+
+					// fast forward to dirty rectangle beginning
+					ptr += (start_column * 2);
+
+					// Write the entire contents of this row in one go.
+					spi_data_runs(ptr, bytes);
+					// yield();
+				}
+			}
+			first_row = last_row + 1;
+		}
+	}
+
+	if (shadow) {
+		for (uint16_t row = start_row; row <= end_row; row++) {
+			memcpy(shadow + row * bytes_per_row + start_column * 2, row_ptr(row) + start_column * 2, bytes);
+		}
+	}
+}
+
+// STATISTICS & FRAME PACING ----------------------------------------------
+
+/*!
+    @brief  Start or stop collecting statistics about display updates,
+            which can then be read with getStats(). The counters only cost
+            a pointer check on the bus paths while disabled.
+    @param  enable
+            true to allocate and reset the statistics, false to free them.
+    @return true on success, false if they could not be allocated.
+*/
+bool Adafruit_SSD1322::enableStats(bool enable)
+{
+	if (!enable) {
+		if (stats) {
+			free(stats);
+			stats = NULL;
+		}
+		return true;
+	}
+
+	if (!stats) {
+		stats = (Stats *)malloc(sizeof(Stats));
+		if (!stats) {
+			return false;
+		}
+	}
+	memset(stats, 0, sizeof(Stats));
+	frame_interval = 0;
+	return true;
+}
+
+/*!
+    @brief  Limit how often display() and displayAsync() actually send an
+            update. A call that comes too soon after the last update either
+            returns without sending anything, leaving the dirty areas to be
+            merged into the next update, or waits for its turn.
+    @param  fps
+            Maximum updates per second, or 0 for no limit.
+    @param  wait
+            If true, wait until the next update is due instead of putting
+            it off, for a steady frame rate.
+    @note   When not waiting, keep calling display() (e.g. every time
+            around loop()) so that a put off update does get sent. When an
+            update takes longer than the frame period the bus can't keep
+            up, so updates are spaced out to leave it idle at least as long
+            as the last update took.
+*/
+void Adafruit_SSD1322::setMaxFrameRate(uint16_t fps, bool wait)
+{
+	frame_period = fps ? 1000000UL / fps : 0;
+	frame_wait = wait;
+	// Don't hold back the first update.
+	frame_start = micros() - frame_period;
+	frame_length = 0;
+}
+
+// Decide whether an update may go out now, waiting for it if asked to.
+bool Adafruit_SSD1322::pace_frame()
+{
+	if (!frame_period) {
+		return true;
+	}
+	uint32_t period = max(frame_period, 2 * frame_length);
+	if (micros() - frame_start >= period) {
+		return true;
+	}
+	if (frame_wait) {
+		while (micros() - frame_start < period) {
+			yield();
+		}
+		return true;
+	}
+	if (stats) {
+		stats->skipped++;
+	}
+	return false;
+}
+
+// An update is about to be sent.
+void Adafruit_SSD1322::frame_begin()
+{
+	uint32_t now = micros();
+	if (stats) {
+		if (stats->frames) {
+			// Exponential moving average of the time between updates.
+			uint32_t interval = now - frame_start;
+			if (frame_interval) {
+				frame_interval = frame_interval - frame_interval / 8 + interval / 8;
+			} else {
+				frame_interval = interval;
+			}
+			if (frame_interval) {
+				stats->fps = 1000000.0f / frame_interval;
+			}
+		}
+		stats->bytes = 0;
+		stats->windows = 0;
+		stats->commands = 0;
+		stats->dc_toggles = 0;
+	}
+	frame_start = now;
+
+	last_update = millis();
+	if (idle_stage != IDLE_ACTIVE) {
+		// A sleeping panel stays off until frame_end(), so it never shows what it held before.
+		leave_idle(true);
+	}
+}
+
+// The last byte of an update has been sent.
+void Adafruit_SSD1322::frame_end()
+{
+	if (wake_display) {
+		spi_command(SSD1322_DISPLAYON);
+		wake_display = false;
+	}
+	frame_length = micros() - frame_start;
+	if (stats) {
+		stats->frames++;
+		stats->micros = frame_length;
+		uint8_t bucket = 0;
+		while ((bucket < SSD1322_STATS_BUCKETS - 1) && (frame_length >= (1000UL << bucket))) {
+			bucket++;
+		}
+		stats->histogram[bucket]++;
+	}
+}
+
+// COMMAND BATCHING --------------------------------------------------------
+
+/*!
+    @brief  Start a batch of commands and data that share one SPI
+            transaction (one chip-select assertion). Batches nest; only
+            the outermost begin_batch()/end_batch() pair touches the bus.
+*/
+void Adafruit_SSD1322::begin_batch()
+{
+	if (batch_depth++ == 0) {
+		if (transport) {
+			transport->select(true);
+		} else if (shared_transaction || fast_soft_spi) {
+			// The panel group already holds the bus, or there is no bus
+			// transaction to start; just select this panel.
+			set_cs(true);
+		} else {
+			spi_dev->beginTransactionWithAssertingCS();
+		}
+		// Something else may have used the DC pin since the last batch.
+		dc_state = -1;
+	}
+}
+
+void Adafruit_SSD1322::end_batch()
+{
+	if (--batch_depth == 0) {
+		if (transport) {
+			transport->select(false);
+		} else if (shared_transaction || fast_soft_spi) {
+			set_cs(false);
+		} else {
+			spi_dev->endTransactionWithDeassertingCS();
+		}
+	}
+}
+
+// Set the DC pin (high for data, low for commands), skipping the write if it's already there.
+void Adafruit_SSD1322::set_dc(bool data)
+{
+	if (dc_state == int8_t(data)) {
+		return;
+	}
+	dc_state = data;
+	if (stats) {
+		stats->dc_toggles++;
+	}
+	if (transport) {
+		transport->setDataMode(data);
+		return;
+	}
+#if defined(BUSIO_USE_FAST_PINIO)
+	if (dcPort) {
+		if (data) {
+			*dcPort |= dcPinMask;
+		} else {
+			*dcPort &= ~dcPinMask;
+		}
+		return;
+	}
+#endif
+	digitalWrite(dcPin, data ? HIGH : LOW);
+}
+
+// Select (active low) or deselect this panel with its CS pin.
+void Adafruit_SSD1322::set_cs(bool active)
+{
+	if (csPin < 0) {
+		return;
+	}
+#if defined(BUSIO_USE_FAST_PINIO)
+	if (csPort) {
+		if (active) {
+			*csPort &= ~csPinMask;
+		} else {
+			*csPort |= csPinMask;
+		}
+		return;
+	}
+#endif
+	digitalWrite(csPin, active ? LOW : HIGH);
+}
+
+// Raw write of bytes inside the current batch.
+void Adafruit_SSD1322::spi_write(const uint8_t *data, size_t count)
+{
+	if (stats) {
+		stats->bytes += count;
+	}
+	if (transport) {
+		transport->write(data, count);
+		return;
+	}
+#if defined(ARDUINO_ARCH_ESP32)
+	if (spi_bus) {
+		spi_bus->writeBytes(data, count);
+		return;
+	}
+#endif
+#if defined(BUSIO_USE_FAST_PINIO)
+	if (fast_soft_spi) {
+		soft_write(data, count);
+		return;
+	}
+#endif
+	while (count--) {
+		spi_dev->transfer(*data++);
+	}
+}
+
+void Adafruit_SSD1322::spi_command(uint8_t c)
+{
+  spi_command_data(c, (uint8_t*)NULL, 0);
+}
+
+void Adafruit_SSD1322::spi_command(uint8_t c, uint8_t d1)
+{
+  spi_command_data(c, &d1, 1);
+}
+
+void Adafruit_SSD1322::spi_command(uint8_t c, uint8_t d1, uint8_t d2)
+{
+  uint8_t buf[] = {d1, d2};
+  spi_command_data(c, buf, 2);
+}
+
+void Adafruit_SSD1322::spi_command_data(uint8_t c, uint8_t *data, size_t count)
+{
+	begin_batch();
+	if (stats) {
+		stats->commands++;
+	}
+	set_dc(false);
+	spi_write(&c, 1);
+	if (count > 0) {
+		if (is_ssd1322()) {
+			// The SSD1322 wants DC pulled high for subsequent bytes of multi-byte commands
+			set_dc(true);
+		}
+		// The SSH1122 wants DC to stay low for all command bytes
+		spi_write(data, count);
+	}
+	end_batch();
+}
+
+void Adafruit_SSD1322::spi_data(uint8_t *data, size_t count)
+{
+	begin_batch();
+	set_dc(true);
+	spi_write(data, count);
+	end_batch();
+}
+
+// Send frame buffer data, with long runs of one byte value (uniform gray,
+// most often blank) handed to spi_fill() instead of being read out of the
+// buffer again byte by byte as they are sent.
+void Adafruit_SSD1322::spi_data_runs(const uint8_t *data, size_t count)
+{
+	begin_batch();
+	set_dc(true);
+	const uint8_t *end = data + count;
+	const uint8_t *literal = data;
+	while (data < end) {
+		const uint8_t *run = data;
+		uint8_t value = *data++;
+		while ((data < end) && (*data == value)) {
+			data++;
+		}
+		if (data - run >= SSD1322_FILL_RUN) {
+			if (run > literal) {
+				spi_write(literal, run - literal);
+			}
+			spi_fill(value, data - run);
+			literal = data;
+		}
+	}
+	if (end > literal) {
+		spi_write(literal, end - literal);
+	}
+	end_batch();
+}
+
+// Send the same byte count times. Neither controller can fill display RAM
+// by itself, so every byte still goes over the bus, but without touching
+// memory for each one.
+void Adafruit_SSD1322::spi_fill(uint8_t value, size_t count)
+{
+	if (stats) {
+		stats->bytes += count;
+	}
+	if (transport) {
+		transport->fill(value, count);
+		return;
+	}
+#if defined(ARDUINO_ARCH_ESP32)
+	if (spi_bus) {
+		uint8_t pattern[4] = {value, value, value, value};
+		spi_bus->writePattern(pattern, sizeof(pattern), count / sizeof(pattern));
+		if (count % sizeof(pattern)) {
+			spi_bus->writeBytes(pattern, count % sizeof(pattern));
+		}
+		return;
+	}
+#endif
+#if defined(BUSIO_USE_FAST_PINIO)
+	if (fast_soft_spi) {
+		soft_fill(value, count);
+		return;
+	}
+#endif
+	while (count--) {
+		spi_dev->transfer(value);
+	}
+}
+
+/*!
+    @brief  Write the same byte count times. Transports that can hold the
+            data lines steady and just strobe should override this.
+    @param  value
+            Byte to write
+    @param  count
+            Number of times to write it
+*/
+void Adafruit_SSD1322_Transport::fill(uint8_t value, size_t count)
+{
+	while (count--) {
+		write(&value, 1);
+	}
+}
+
+#if defined(BUSIO_USE_FAST_PINIO)
+// Bitbang one bit of b in SPI mode 0: set MOSI, then pulse the clock. The
+// clock is held low and high for SSD1322_SOFT_SPI_NS each.
+#define SOFT_SPI_BIT(b, bit)                                                   \
+	if ((b) & (bit)) {                                                         \
+		*mosiPort |= mosiPinMask;                                              \
+	} else {                                                                   \
+		*mosiPort &= ~mosiPinMask;                                             \
+	}                                                                          \
+	SSD1322_BUS_DELAY(SSD1322_SOFT_SPI_NS);                                    \
+	*clkPort |= clkPinMask;                                                    \
+	SSD1322_BUS_DELAY(SSD1322_SOFT_SPI_NS);                                    \
+	*clkPort &= ~clkPinMask;
+
+#define SOFT_SPI_BYTE(b)                                                       \
+	SOFT_SPI_BIT(b, 0x80) SOFT_SPI_BIT(b, 0x40) SOFT_SPI_BIT(b, 0x20)         \
+	SOFT_SPI_BIT(b, 0x10) SOFT_SPI_BIT(b, 0x08) SOFT_SPI_BIT(b, 0x04)         \
+	SOFT_SPI_BIT(b, 0x02) SOFT_SPI_BIT(b, 0x01)
+
+#define SOFT_SPI_CLOCK()                                                       \
+	SSD1322_BUS_DELAY(SSD1322_SOFT_SPI_NS);                                    \
+	*clkPort |= clkPinMask;                                                    \
+	SSD1322_BUS_DELAY(SSD1322_SOFT_SPI_NS);                                    \
+	*clkPort &= ~clkPinMask;
+
+// Bitbang bytes MSB first through the cached port registers.
+void Adafruit_SSD1322::soft_write(const uint8_t *data, size_t count)
+{
+	while (count--) {
+		uint8_t b = *data++;
+		SOFT_SPI_BYTE(b)
+	}
+}
+
+// Bitbang the same byte count times. Blank and full-white runs keep MOSI
+// at one level throughout, so only the clock has to move.
+void Adafruit_SSD1322::soft_fill(uint8_t value, size_t count)
+{
+	if ((value == 0x00) || (value == 0xFF)) {
+		if (value) {
+			*mosiPort |= mosiPinMask;
+		} else {
+			*mosiPort &= ~mosiPinMask;
+		}
+		while (count--) {
+			SOFT_SPI_CLOCK() SOFT_SPI_CLOCK() SOFT_SPI_CLOCK() SOFT_SPI_CLOCK()
+			SOFT_SPI_CLOCK() SOFT_SPI_CLOCK() SOFT_SPI_CLOCK() SOFT_SPI_CLOCK()
+		}
+		return;
+	}
+	while (count--) {
+		SOFT_SPI_BYTE(value)
+	}
+}
+#endif
+
+/*!
+    @brief  Enable or disable display invert mode (white-on-black vs
+            black-on-white). Handy for testing!
+    @param  i
+            If true, switch to invert mode (black-on-white), else normal
+            mode (white-on-black).
+*/
+void Adafruit_SSD1322::invertDisplay(bool i) {
+  waitForDisplay();
+  spi_command(i ? SSD1322_INVERTDISPLAY : SSD1322_NORMALDISPLAY);
+}
+
+/*!
+    @brief  Send a single command byte over whichever bus the display is
+            on. This hides the superclass version, which only knows I2C and
+            SPI devices and has nothing to send through with a transport.
+    @param  c
+            Command byte
+    @note   The superclass functions aren't virtual, so calls made through
+            an Adafruit_GrayOLED pointer still reach the superclass version,
+            which is only safe on SPI.
+*/
+void Adafruit_SSD1322::oled_command(uint8_t c)
+{
+	waitForDisplay();
+	spi_command(c);
+}
+
+/*!
+    @brief  Send a list of bytes, all with D/C low, over whichever bus the
+            display is on. Hides the superclass version, as oled_command()
+            does.
+    @param  c
+            Bytes to send
+    @param  n
+            Number of bytes
+    @return true
+*/
+bool Adafruit_SSD1322::oled_commandList(const uint8_t *c, uint8_t n)
+{
+	waitForDisplay();
+	begin_batch();
+	if (stats) {
+		stats->commands += n;
+	}
+	set_dc(false);
+	spi_write(c, n);
+	end_batch();
+	return true;
+}
+
+void Adafruit_SSD1322::setContrast(uint8_t level)
+{
+	waitForDisplay();
+	contrast = level;
+	if (idle_stage != IDLE_ACTIVE) {
+		// Takes effect when the panel wakes up.
+		return;
+	}
+	if (is_ssd1322()) {
+		spi_command(SSD1322_SETCONTRASTCURRENT, level);
+	} else {
+		spi_command(SH1122_SETCONTRAST, level);
+	}
+}
+
+// IDLE POWER SAVING -------------------------------------------------------
+
+/*!
+    @brief  Save power (and panel life) when the picture stops changing.
+            Each time display() or displayAsync() finds nothing to send, the
+            time since the last update is checked against these timeouts,
+            and the panel is dimmed, then its refresh rate lowered, then it
+            is turned off. The next update that does change something
+            undoes all of it, with the panel turned back on only after the
+            new picture is written.
+    @param  dim_seconds
+            Seconds without an update before lowering the contrast (and on
+            the SSD1322 the master current), or 0 not to dim.
+    @param  slow_seconds
+            Seconds before slowing the display clock, or 0 not to.
+    @param  sleep_seconds
+            Seconds before turning the panel off, or 0 not to.
+    @param  dim_contrast
+            Contrast while dimmed, as for setContrast().
+    @note   Pass all zeros to turn idle power saving off again. Keep
+            calling display() (e.g. every time around loop()) for the
+            timeouts to be noticed.
+*/
+void Adafruit_SSD1322::setIdleTimeouts(uint16_t dim_seconds, uint16_t slow_seconds,
+                                       uint16_t sleep_seconds, uint8_t dim_contrast)
+{
+	idle_seconds[0] = dim_seconds;
+	idle_seconds[1] = slow_seconds;
+	idle_seconds[2] = sleep_seconds;
+	this->dim_contrast = dim_contrast;
+	last_update = millis();
+	wake();
+}
+
+/*!
+    @brief  Bring the panel back to full brightness and speed straight
+            away, e.g. when a button is pressed, and restart the idle
+            timeouts.
+*/
+void Adafruit_SSD1322::wake(void)
+{
+	waitForDisplay();
+	last_update = millis();
+	if (idle_stage != IDLE_ACTIVE) {
+		leave_idle(false);
+	}
+}
+
+// Move on to the next power saving stages whose timeouts have passed.
+void Adafruit_SSD1322::check_idle()
+{
+	uint32_t idle = millis() - last_update;
+	for (uint8_t stage = idle_stage + 1; stage <= IDLE_SLEEP; stage++) {
+		uint16_t seconds = idle_seconds[stage - 1];
+		if (seconds == 0) {
+			continue;
+		}
+		if (idle < seconds * 1000UL) {
+			return;
+		}
+
+		begin_batch();
+		if (stage == IDLE_DIM) {
+			if (is_ssd1322()) {
+				spi_command(SSD1322_SETCONTRASTCURRENT, dim_contrast);
+				spi_command(SSD1322_MASTERCURRENTCONTROL, SSD1322_IDLE_MASTERCURRENT);
+			} else {
+				spi_command(SH1122_SETCONTRAST, dim_contrast);
+			}
+		} else if (stage == IDLE_SLOW) {
+			send_display_clock(true);
+		} else {
+			spi_command(SSD1322_DISPLAYOFF);
+		}
+		end_batch();
+		idle_stage = stage;
+	}
+}
+
+// Undo the power saving stages. The panel is either turned on straight
+// away or, if an update is on its way, once it has been written.
+void Adafruit_SSD1322::leave_idle(bool defer_display_on)
+{
+	begin_batch();
+	if (is_ssd1322()) {
+		spi_command(SSD1322_SETCONTRASTCURRENT, contrast);
+		spi_command(SSD1322_MASTERCURRENTCONTROL, 0x0F);
+	} else {
+		spi_command(SH1122_SETCONTRAST, contrast);
+	}
+	send_display_clock(false);
+	if (idle_stage == IDLE_SLEEP) {
+		if (defer_display_on) {
+			wake_display = true;
+		} else {
+			spi_command(SSD1322_DISPLAYON);
+		}
+	}
+	end_batch();
+	idle_stage = IDLE_ACTIVE;
+}
+
+/*!
+    @brief  Guard against burn-in by slowly moving the whole picture up and
+            down a few rows, using the controller's display offset so that
+            nothing has to be sent again. On the SH1122, whose display RAM
+            is as tall as the panel, rows moved off one edge appear at the
+            other. The SSD1322 shows rows of display RAM from outside the
+            picture instead, which are kept blank (they are cleared here and
+            again whenever the start line moves). Either way, leave that
+            many blank rows at the top or bottom of the layout.
+    @param  rows
+            Largest offset in rows, or 0 to turn pixel shifting off.
+    @param  seconds
+            Time between steps of one row, checked on each display().
+*/
+void Adafruit_SSD1322::setPixelShift(uint8_t rows, uint16_t seconds)
+{
+	waitForDisplay();
+	shift_rows = rows;
+	shift_seconds = seconds;
+	shift_time = millis();
+	shift_step = 0;
+	if (buffer && !(partial_rows && !is_ssd1322())) {
+		send_display_offset(0);
+		clear_shift_rows();
+	}
+}
+
+// Blank the rows of SSD1322 display RAM that a pixel shift can bring into
+// view: up to shift_rows of them past either end of the picture, wherever
+// the start line has put it. They can hold anything from power-up, or rows
+// scrolled off long ago.
+void Adafruit_SSD1322::clear_shift_rows()
+{
+	if (!is_ssd1322() || !shift_rows) {
+		return;
+	}
+	uint16_t ring = ram_rows();
+	uint16_t rows = min(uint16_t(shift_rows), uint16_t(ring - HEIGHT));
+	uint16_t first[2] = {uint16_t(HEIGHT), uint16_t(ring - rows)};
+
+	begin_batch();
+	for (uint8_t i = 0; i < 2; i++) {
+		uint16_t end = first[i] + rows - 1;
+		for (uint16_t row = first[i]; row <= end;) {
+			uint16_t last = start_write(0, row, WIDTH / 4 - 1, end);
+			set_dc(true);
+			spi_fill(0, uint32_t(last - row + 1) * (WIDTH / 2));
+			row = last + 1;
+		}
+	}
+	end_batch();
+}
+
+// Take the next pixel shift step if it's due, going 0, 1 ... rows ... 1, 0.
+void Adafruit_SSD1322::check_pixel_shift()
+{
+	// The SH1122 needs the display offset to place a partial display strip.
+	if (partial_rows && !is_ssd1322()) {
+		return;
+	}
+	if (!shift_rows || (millis() - shift_time < shift_seconds * 1000UL)) {
+		return;
+	}
+	shift_time = millis();
+	shift_step = (shift_step + 1) % (2 * shift_rows);
+	send_display_offset((shift_step <= shift_rows) ? shift_step : 2 * shift_rows - shift_step);
+}
+
+// GRAY LEVELS -------------------------------------------------------------
+
+/*!
+    @brief  Upload a custom gray scale table, which sets the pixel drive
+            (brightness) for each of gray levels 1 to 15. SSD1322 only.
+    @param  table
+            15 values from 0 to 180, each larger than the one before.
+    @return true if the table was sent, false if it isn't valid or the
+            controller is an SH1122, which has no gray scale table.
+*/
+bool Adafruit_SSD1322::setGrayTable(const uint8_t table[15])
+{
+	if (!is_ssd1322()) {
+		return false;
+	}
+	for (uint8_t i = 0; i < 15; i++) {
+		if ((table[i] > 180) || ((i > 0) && (table[i] <= table[i - 1]))) {
+			return false;
+		}
+	}
+
+	uint8_t data[15];
+	memcpy(data, table, sizeof(data));
+	waitForDisplay();
+	begin_batch();
+	spi_command_data(SSD1322_GRAYTABLE, data, sizeof(data));
+	spi_command(SSD1322_ENABLEGRAYSCALETABLE);
+	end_batch();
+	gray_top = table[14];
+	return true;
+}
+
+/*!
+    @brief  Upload a gray scale table following a power curve, so that the
+            16 gray levels are spaced evenly in perceived brightness.
+            SSD1322 only.
+    @param  gamma
+            Exponent of the curve; 1.0 is linear, around 2.2 is typical.
+    @return true if the table was sent, false on an SH1122 or if gamma
+            isn't greater than 0.
+*/
+bool Adafruit_SSD1322::setGrayTableGamma(float gamma)
+{
+	if (!(gamma > 0)) {
+		return false;
+	}
+	uint8_t table[15];
+	uint8_t previous = 0;
+	for (uint8_t i = 0; i < 15; i++) {
+		uint8_t value = uint8_t(pow((i + 1) / 15.0, gamma) * 180 + 0.5);
+		// The levels have to be distinct, which the bottom of a steep curve isn't.
+		if (value <= previous) {
+			value = previous + 1;
+		}
+		table[i] = previous = value;
+	}
+	return setGrayTable(table);
+}
+
+/*!
+    @brief  Go back to the controller's built-in (linear) gray scale table.
+*/
+void Adafruit_SSD1322::setDefaultGrayTable(void)
+{
+	if (is_ssd1322()) {
+		waitForDisplay();
+		spi_command(SSD1322_SELECTDEFAULTGRAYSCALE);
+		gray_top = 180;
+	}
+}
+
+/*!
+    @brief  Set the curve used to turn 8-bit luminance into gray levels in
+            drawGrayBitmap8() and luminanceToGray(). The curve is worked
+            out once into a 256 byte table, so it costs nothing per pixel.
+    @param  gamma
+            Exponent applied to the luminance; 1.0 (the default) maps it
+            linearly and frees the table. Leave this at 1.0 if the panel's
+            own gray scale table already corrects for gamma.
+    @return true on success, false if the table could not be allocated.
+*/
+bool Adafruit_SSD1322::setLuminanceGamma(float gamma)
+{
+	if (gamma == 1.0f) {
+		if (luminance_lut) {
+			free(luminance_lut);
+			luminance_lut = NULL;
+		}
+		return true;
+	}
+
+	if (!luminance_lut) {
+		luminance_lut = (uint8_t *)malloc(256);
+		if (!luminance_lut) {
+			return false;
+		}
+	}
+	for (uint16_t v = 0; v < 256; v++) {
+		luminance_lut[v] = uint8_t(pow(v / 255.0, gamma) * 240 + 0.5);
+	}
+	return true;
+}
+
+/*!
+    @brief  Convert 8-bit luminance to the nearest gray level, with the same
+            curve as drawGrayBitmap8(), e.g. to pick fill colors for
+            sensor data.
+    @param  luminance
+            0 (black) to 255 (white)
+    @return Gray level, 0 to 15
+*/
+uint8_t Adafruit_SSD1322::luminanceToGray(uint8_t luminance)
+{
+	uint8_t f = luminance_lut ? luminance_lut[luminance] : pgm_read_byte(&linear_luminance[luminance]);
+	return (f + 8) >> 4;
+}
+
+/*!
+    @brief  Enable or disable the shadow buffer. The shadow buffer holds a
+            copy of what was last sent to display RAM, and lets display()
+            send only the bytes that have actually changed inside each
+            dirty rectangle. It costs another WIDTH * HEIGHT / 2 bytes of
+            RAM (8 KB for a 256x64 display).
+    @param  enable
+            true to allocate the shadow buffer, false to free it.
+    @return true on success, false if the shadow buffer could not be
+            allocated.
+    @note   The next display() after enabling sends the whole screen, to
+            bring the shadow buffer and display RAM into sync.
+*/
+bool Adafruit_SSD1322::enableShadowBuffer(bool enable)
+{
+	if (!enable) {
+		if (shadow) {
+			free(shadow);
+			shadow = NULL;
+		}
+		shadow_valid = false;
+		return true;
+	}
+	if (band_rows) {
+		return false;
+	}
+
+	if (!shadow) {
+		shadow = (uint8_t *)malloc(WIDTH * HEIGHT / 2);
+		if (!shadow) {
+			return false;
+		}
+		shadow_valid = false;
+		dirty_rect all = {0, band_y1, int16_t(WIDTH - 1), band_y2};
+		add_dirty(all);
+	}
+	return true;
+}
+
+// ASYNCHRONOUS DISPLAY ----------------------------------------------------
+
+/*!
+    @brief  Enable or disable asynchronous display updates. This allocates
+            a second frame buffer (WIDTH * HEIGHT / 2 bytes) that
+            displayAsync() copies the dirty areas into, so drawing into
+            the main buffer can carry on while they are being sent.
+    @param  enable
+            true to allocate the second buffer, false to free it.
+    @return true on success, false if the buffer could not be allocated.
+*/
+bool Adafruit_SSD1322::enableAsyncDisplay(bool enable)
+{
+	if (!enable) {
+		waitForDisplay();
+		if (back) {
+			free(back);
+			back = NULL;
+		}
+#if SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_ESP32)
+		if (dma_task) {
+			vTaskDelete(dma_task);
+			dma_task = NULL;
+		}
+#endif
+		return true;
+	}
+	if (band_rows) {
+		return false;
+	}
+
+	if (!back) {
+		back = (uint8_t *)malloc(WIDTH * HEIGHT / 2);
+	}
+#if SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_ESP32)
+	if (back && spi_bus && !dma_task) {
+		// Without a task the update falls back to the cooperative pump.
+		xTaskCreate(dma_worker, "SSD1322", 2048, this, uxTaskPriorityGet(NULL), &dma_task);
+	}
+#endif
+	return back != NULL;
+}
+
+/*!
+    @brief  Start writing the dirty areas of the frame buffer to display RAM
+            without waiting for the transfer to finish. The dirty areas are
+            copied to the second buffer first, so the main buffer may be
+            drawn into as soon as this returns.
+            On hardware SPI with SSD1322_ASYNC_DMA (Adafruit SAMD, RP2040
+            and ESP32 cores), the rows of each window are handed to the core
+            as non-blocking transfers and go out in the background; isBusy()
+            only has to be called now and then to start the next window.
+            Elsewhere (software SPI, other cores, custom transports, panel
+            groups) there is no background transfer: the update is sent in
+            chunks of about SSD1322_ASYNC_CHUNK bytes each time isBusy() is
+            called, and nothing is sent between calls.
+            Either way, waitForDisplay() runs the update to completion.
+    @note   Falls back to display() if enableAsyncDisplay() hasn't been
+            called. Starting a new update first finishes the previous one,
+            as does anything else that sends commands, such as
+            setContrast() or invertDisplay().
+            While a background transfer is running, this panel holds the
+            SPI bus, so other devices on it must wait for isBusy() to
+            return false.
+*/
+void Adafruit_SSD1322::displayAsync(void)
+{
+	if (!back) {
+		display();
+		return;
+	}
+
+	waitForDisplay();
+	fold_window();
+	check_pixel_shift();
+	if ((dirty_count == 0) && !start_line_pending) {
+		check_idle();
+		return;
+	}
+	if (!pace_frame()) {
+		return;
+	}
+	frame_begin();
+
+	uint16_t bytes_per_row = WIDTH / 2;
+	async_count = 0;
+	for (uint8_t i = 0; i < dirty_count; i++) {
+		dirty_rect &w = async_windows[async_count++];
+		window_columns(dirty[i].x1, dirty[i].x2, dirty[i].y2 - dirty[i].y1 + 1, w.x1, w.x2);
+		w.y1 = dirty[i].y1;
+		w.y2 = dirty[i].y2;
+
+		size_t bytes = (w.x2 - w.x1 + 1) * 2;
+		for (int16_t row = w.y1; row <= w.y2; row++) {
+			memcpy(back + row * bytes_per_row + w.x1 * 2, row_ptr(row) + w.x1 * 2, bytes);
+		}
+	}
+	dirty_count = 0;
+	if (start_line_pending) {
+		// The start line command is queued behind the rows.
+		async_start_line = true;
+	}
+
+	// Asynchronous updates always send whole windows, so the shadow buffer
+	// is kept up to date (and becomes valid) the same way as in display().
+	if (shadow) {
+		shadow_valid = true;
+	}
+
+	async_index = 0;
+	if (async_count > 0) {
+		async_row = async_windows[0].y1;
+		pump_async();
+	} else {
+		// Only the start line changed.
+		send_start_line();
+		async_start_line = false;
+		frame_end();
+	}
+}
+
+/*!
+    @brief  Continue an asynchronous display update: check whether the
+            background transfer has finished and start the next one, or
+            send the next chunk where there are no background transfers.
+    @return true if part of the update is still waiting to be sent.
+*/
+bool Adafruit_SSD1322::isBusy(void)
+{
+	if (async_index < async_count) {
+		pump_async();
+	}
+	return async_index < async_count;
+}
+
+/*!
+    @brief  Finish any asynchronous display update that is in progress.
+*/
+void Adafruit_SSD1322::waitForDisplay(void)
+{
+	while (async_index < async_count) {
+		pump_async();
+	}
+}
+
+// Move an asynchronous display update along: finish the background
+// transfer if it is done, then start (or send) the next rows.
+void Adafruit_SSD1322::pump_async()
+{
+	if (async_dma) {
+		if (!dma_done()) {
+			return;
+		}
+		async_dma = false;
+		end_batch();
+		next_async_window();
+		if (async_index >= async_count) {
+			return;
+		}
+	}
+	send_async_rows();
+	if (!async_dma) {
+		next_async_window();
+	}
+}
+
+// Send the next rows of the current window: as one background transfer
+// where the core has them, or as a chunk of about SSD1322_ASYNC_CHUNK bytes.
+void Adafruit_SSD1322::send_async_rows()
+{
+	uint16_t bytes_per_row = WIDTH / 2;
+	dirty_rect &w = async_windows[async_index];
+	size_t bytes = (w.x2 - w.x1 + 1) * 2;
+
+	begin_batch();
+	if (dma_usable()) {
+		bool new_window = (async_row == w.y1) || (async_row > async_last);
+		if (new_window) {
+			async_last = start_write(w.x1, async_row, w.x2, w.y2);
+		}
+		// A full-width window is one run of the back buffer up to where
+		// display RAM wraps; narrower ones go a row at a time.
+		uint16_t rows = 1;
+		if (bytes == bytes_per_row) {
+			rows = async_last - async_row + 1;
+			if (new_window) {
+				continue_write(w.x1, async_row);
+			}
+		} else {
+			continue_write(w.x1, async_row);
+		}
+		uint16_t offset = async_row * bytes_per_row + w.x1 * 2;
+		size_t count = bytes * rows;
+		if (shadow) {
+			memcpy(shadow + offset, back + offset, count);
+		}
+		if (stats) {
+			stats->bytes += count;
+		}
+		set_dc(true);
+		dma_start(back + offset, count);
+		async_dma = true;
+		async_row += rows;
+		// The batch is ended by pump_async() once the transfer is done.
+		return;
+	}
+
+	size_t sent = 0;
+	do {
+		bool new_window = (async_row == w.y1) || (async_row > async_last);
+		if (new_window) {
+			async_last = start_write(w.x1, async_row, w.x2, w.y2);
+		}
+		// Full-width windows only need to be addressed once; see write_window().
+		if ((bytes != bytes_per_row) || new_window) {
+			continue_write(w.x1, async_row);
+		}
+		uint16_t offset = async_row * bytes_per_row + w.x1 * 2;
+		spi_data_runs(back + offset, bytes);
+		if (shadow) {
+			memcpy(shadow + offset, back + offset, bytes);
+		}
+		sent += bytes;
+		async_row++;
+	} while ((async_row <= w.y2) && (sent < SSD1322_ASYNC_CHUNK));
+	end_batch();
+}
+
+// Move on to the next window once the current one has been sent, and
+// finish the frame after the last.
+void Adafruit_SSD1322::next_async_window()
+{
+	if (async_row <= async_windows[async_index].y2) {
+		return;
+	}
+	if (++async_index < async_count) {
+		async_row = async_windows[async_index].y1;
+	} else {
+		async_index = async_count = 0;
+		if (async_start_line) {
+			send_start_line();
+			async_start_line = false;
+		}
+		frame_end();
+	}
+}
+
+// Non-blocking transfers need the core's own SPI class, and a bus this
+// panel has to itself.
+bool Adafruit_SSD1322::dma_usable()
+{
+#if SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_ESP32)
+	return dma_task && spi_bus && !transport && !shared_transaction;
+#elif SSD1322_ASYNC_DMA && (defined(ARDUINO_ARCH_SAMD) || defined(ARDUINO_ARCH_RP2040))
+	return spi_bus && !transport && !shared_transaction;
+#else
+	return false;
+#endif
+}
+
+// Start sending count bytes of frame data without waiting for them. Only
+// called when dma_usable().
+void Adafruit_SSD1322::dma_start(const uint8_t *data, size_t count)
+{
+#if SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_ESP32)
+	dma_data = data;
+	dma_count = count;
+	xTaskNotifyGive(dma_task);
+#elif SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_SAMD)
+	spi_bus->transfer(data, NULL, count, false);
+#elif SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_RP2040)
+	static_cast<SPIClassRP2040 *>(spi_bus)->transferAsync(data, NULL, count);
+#else
+	(void)data;
+	(void)count;
+#endif
+}
+
+// Check whether the transfer started by dma_start() has finished.
+bool Adafruit_SSD1322::dma_done()
+{
+#if SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_ESP32)
+	return dma_count == 0;
+#elif SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_SAMD)
+	return !spi_bus->isBusy();
+#elif SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_RP2040)
+	return static_cast<SPIClassRP2040 *>(spi_bus)->finishedAsync();
+#else
+	return true;
+#endif
+}
+
+#if SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_ESP32)
+// The ESP32 core's SPI writes block, so they run in this task while the
+// sketch carries on. The panel's batch (and with it the bus transaction)
+// is held by the caller for the length of each job.
+void Adafruit_SSD1322::dma_worker(void *arg)
+{
+	Adafruit_SSD1322 *display = (Adafruit_SSD1322 *)arg;
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		display->spi_bus->writeBytes(display->dma_data, display->dma_count);
+		display->dma_count = 0;
+	}
+}
+#endif
+
+// BAND RENDERING ----------------------------------------------------------
+
+/*!
+    @brief  Draw and send the whole screen a band of rows at a time. For
+            each band, the band buffer is cleared, draw is called to draw
+            the entire screen (anything outside the band is clipped away
+            cheaply), and the band is written to display RAM before moving
+            on to the next one.
+    @param  draw
+            Draws the screen using the usual GFX calls. It is called once
+            per band, so it must draw the same thing each time.
+    @param  context
+            Passed through to draw.
+    @note   Without beginBanded(), this just calls draw once and then
+            display().
+    @note   Each call is one update, as display() would be: it is counted
+            by enableStats(), paced by setMaxFrameRate() (draw isn't called
+            at all for an update that is put off), wakes the panel from
+            setIdleTimeouts() and takes any pixel shift step that is due.
+            Calling display() in between only checks the idle timeouts and
+            pixel shift.
+*/
+void Adafruit_SSD1322::renderBands(void (*draw)(Adafruit_SSD1322 &display, void *context),
+                                   void *context)
+{
+	if (!band_rows) {
+		draw(*this, context);
+		display();
+		return;
+	}
+
+	yield();
+	check_pixel_shift();
+	if (!pace_frame()) {
+		return;
+	}
+	frame_begin();
+	for (int16_t top = 0; top < HEIGHT; top += band_rows) {
+		band_y1 = top;
+		band_y2 = min(int16_t(top + band_rows - 1), int16_t(HEIGHT - 1));
+		memset(buffer, 0, (band_y2 - band_y1 + 1) * (WIDTH / 2));
+		reset_window();
+
+		draw(*this, context);
+
+		// The whole band goes out regardless of what was drawn, since the
+		// cleared rows need to reach display RAM too.
+		begin_batch();
+		flush_window(0, band_y1, WIDTH - 1, band_y2);
+		end_batch();
+		reset_window();
+		dirty_count = 0;
+	}
+	frame_end();
+	yield();
+
+	band_y1 = 0;
+	band_y2 = band_rows - 1;
+}
+
+// HARDWARE SCROLLING ------------------------------------------------------
+
+/*!
+    @brief  Scroll the whole display vertically by moving the display start
+            line, treating display RAM as a ring buffer. The frame buffer
+            is scrolled along with it, and only the rows that scroll into
+            view are cleared and marked dirty, so the next display() sends
+            just those rows plus a single command instead of the whole
+            screen.
+    @param  rows
+            Number of rows to scroll the contents up by (new rows appear
+            at the bottom). Negative values scroll down.
+    @note   The panel itself moves during the next display(), after the
+            newly exposed rows have been written.
+*/
+void Adafruit_SSD1322::scrollVertical(int16_t rows)
+{
+	if ((rows == 0) || band_rows || partial_rows) {
+		return;
+	}
+
+	// Rows queued for an asynchronous update would land in the wrong place after this.
+	waitForDisplay();
+	fold_window();
+
+	uint16_t bytes_per_row = WIDTH / 2;
+	uint16_t count = abs(rows);
+	if (count >= HEIGHT) {
+		// Nothing survives the scroll.
+		memset(buffer, 0, HEIGHT * bytes_per_row);
+		dirty_count = 0;
+		dirty_rect all = {0, 0, int16_t(WIDTH - 1), int16_t(HEIGHT - 1)};
+		add_dirty(all);
+		return;
+	}
+
+	uint16_t kept = (HEIGHT - count) * bytes_per_row;
+	dirty_rect exposed = {0, 0, int16_t(WIDTH - 1), int16_t(count - 1)};
+	if (rows > 0) {
+		memmove(buffer, buffer + count * bytes_per_row, kept);
+		memset(buffer + kept, 0, count * bytes_per_row);
+		if (shadow) {
+			memmove(shadow, shadow + count * bytes_per_row, kept);
+		}
+		exposed.y1 = HEIGHT - count;
+		exposed.y2 = HEIGHT - 1;
+	} else {
+		memmove(buffer + count * bytes_per_row, buffer, kept);
+		memset(buffer, 0, count * bytes_per_row);
+		if (shadow) {
+			memmove(shadow + count * bytes_per_row, shadow, kept);
+		}
+	}
+
+	// Anything still waiting to be sent moved with the contents.
+	uint8_t old_count = dirty_count;
+	dirty_rect old[SSD1322_MAX_DIRTY_RECTS];
+	memcpy(old, dirty, sizeof(dirty_rect) * old_count);
+	dirty_count = 0;
+	for (uint8_t i = 0; i < old_count; i++) {
+		old[i].y1 = max(int16_t(0), int16_t(old[i].y1 - rows));
+		old[i].y2 = min(int16_t(HEIGHT - 1), int16_t(old[i].y2 - rows));
+		if (old[i].y1 <= old[i].y2) {
+			add_dirty(old[i]);
+		}
+	}
+	add_dirty(exposed);
+
+	// What display RAM holds in the exposed rows isn't known, so don't diff against the shadow buffer until they're sent.
+	shadow_valid = false;
+
+	int16_t ring = ram_rows();
+	start_line = uint8_t(((start_line + rows) % ring + ring) % ring);
+	start_line_pending = true;
+}
+
+// Send the current start line to the controller.
+void Adafruit_SSD1322::send_start_line()
+{
+	if (is_ssd1322()) {
+		spi_command(SSD1322_SETSTARTLINE, start_line);
+	} else {
+		spi_command(SH1122_SETSTARTLINE | start_line);
+	}
+	start_line_pending = false;
+	// Different rows of display RAM lie next to the picture now.
+	clear_shift_rows();
+}
+
+// PARTIAL DISPLAY ---------------------------------------------------------
+
+/*!
+    @brief  Show only a strip of rows, such as a status bar, and blank the
+            rest of the panel. The frame buffer is shrunk to just the strip,
+            so drawing, dirty tracking and display() all cover only those
+            rows, and everything drawn outside them is clipped away.
+    @param  y
+            First row shown, counted from the top of the panel as it is in
+            rotation 0, whatever the rotation
+    @param  rows
+            Number of rows shown
+    @return true on success. false if the strip doesn't fit on the screen,
+            is shorter than the controller allows, in band mode, or if the
+            new buffer couldn't be allocated, in which case nothing has
+            changed.
+    @note   The SSD1322 can show a strip of any height from 1 row. The
+            SH1122's multiplex ratio only goes down to 16 rows, so its
+            strips must be at least that tall.
+    @note   What was already drawn in the strip is kept. On the SH1122 the
+            strip is shown by cutting the multiplex ratio, which also
+            shortens the frame and so raises the refresh rate, and uses the
+            display offset, so setPixelShift() is paused meanwhile. The
+            SSD1322's partial display mode keeps scanning every row, so
+            only the power for the blanked rows is saved. Its strip has to
+            be one run of display RAM rows, so the start line may be put
+            back to 0 (and the strip sent again) to keep it from wrapping.
+            scrollVertical() does nothing in partial mode.
+*/
+bool Adafruit_SSD1322::enablePartialDisplay(int16_t y, uint8_t rows)
+{
+	if (band_rows || !buffer || (rows == 0) || (y < 0) || (y + rows > HEIGHT)) {
+		return false;
+	}
+	// The SH1122 takes multiplex ratios of 0x0F to 0x3F.
+	if (!is_ssd1322() && (rows < 16)) {
+		return false;
+	}
+	waitForDisplay();
+	fold_window();
+	if (flipped) {
+		// The controller shows the frame buffer upside down.
+		y = HEIGHT - y - rows;
+	}
+
+	uint16_t bytes_per_row = WIDTH / 2;
+	uint8_t *strip = (uint8_t *)malloc(rows * bytes_per_row);
+	if (!strip) {
+		return false;
+	}
+	for (int16_t row = y; row < y + rows; row++) {
+		uint8_t *dest = strip + (row - y) * bytes_per_row;
+		if ((row >= band_y1) && (row <= band_y2)) {
+			memcpy(dest, row_ptr(row), bytes_per_row);
+		} else {
+			memset(dest, 0, bytes_per_row);
+		}
+	}
+	free(buffer);
+	buffer = strip;
+
+	// Changes outside the strip will never be shown now.
+	clip_dirty(y, y + rows - 1);
+	band_y1 = y;
+	band_y2 = y + rows - 1;
+	partial_rows = rows;
+
+	begin_batch();
+	send_partial_display();
+	end_batch();
+	return true;
+}
+
+/*!
+    @brief  Go back to showing the whole screen after enablePartialDisplay().
+            The full frame buffer is allocated again, with the strip copied
+            into place and the rest cleared, and the whole screen is sent on
+            the next display().
+    @return true on success, or false if the full buffer couldn't be
+            allocated, in which case partial mode carries on.
+*/
+bool Adafruit_SSD1322::disablePartialDisplay(void)
+{
+	if (!partial_rows) {
+		return true;
+	}
+	waitForDisplay();
+	fold_window();
+
+	uint16_t bytes_per_row = WIDTH / 2;
+	uint8_t *full = (uint8_t *)malloc(HEIGHT * bytes_per_row);
+	if (!full) {
+		return false;
+	}
+	memset(full, 0, HEIGHT * bytes_per_row);
+	memcpy(full + band_y1 * bytes_per_row, buffer, partial_rows * bytes_per_row);
+	free(buffer);
+	buffer = full;
+
+	band_y1 = 0;
+	band_y2 = HEIGHT - 1;
+	partial_rows = 0;
+	dirty_rect all = {0, 0, int16_t(WIDTH - 1), int16_t(HEIGHT - 1)};
+	add_dirty(all);
+	// The shadow buffer only followed display RAM inside the strip.
+	shadow_valid = false;
+
+	begin_batch();
+	send_partial_display();
+	end_batch();
+	return true;
+}
+
+// Tell the controller which rows to show: the partial display strip, or
+// all of them.
+void Adafruit_SSD1322::send_partial_display()
+{
+	if (is_ssd1322()) {
+		if (partial_rows) {
+			if (physical_row(band_y2) < physical_row(band_y1)) {
+				// The strip has to be one run of display RAM rows, which
+				// it is again with the picture starting from row 0.
+				start_line = 0;
+				send_start_line();
+				dirty_rect strip = {0, band_y1, int16_t(WIDTH - 1), band_y2};
+				add_dirty(strip);
+				shadow_valid = false;
+			}
+			spi_command(SSD1322_ENTERPARTIALDISPLAY, physical_row(band_y1), physical_row(band_y2));
+		} else {
+			spi_command(SSD1322_EXITPARTIALDISPLAY);
+		}
+		return;
+	}
+
+	if (partial_rows) {
+		// Scan only the strip's rows, starting from its first row in RAM,
+		// and move them back down to where they sit on the panel.
+		spi_command(SSD1322_SETMULTIPLEX, partial_rows - 1);
+		spi_command(SH1122_SETSTARTLINE | physical_row(band_y1));
+		send_display_offset((ram_rows() - band_y1) % ram_rows());
+		// That already takes in any scroll that was waiting to be sent.
+		start_line_pending = false;
+	} else {
+		spi_command(SSD1322_SETMULTIPLEX, HEIGHT - 1);
+		send_start_line();
+		shift_step = 0;
+		send_display_offset(0);
+	}
+}
+
+// Trim the dirty list to a range of rows.
+void Adafruit_SSD1322::clip_dirty(int16_t y1, int16_t y2)
+{
+	uint8_t old_count = dirty_count;
+	dirty_rect old[SSD1322_MAX_DIRTY_RECTS];
+	memcpy(old, dirty, sizeof(dirty_rect) * old_count);
+	dirty_count = 0;
+	for (uint8_t i = 0; i < old_count; i++) {
+		old[i].y1 = max(old[i].y1, y1);
+		old[i].y2 = min(old[i].y2, y2);
+		if (old[i].y1 <= old[i].y2) {
+			add_dirty(old[i]);
+		}
+	}
+}
+
+// TEAR-FREE UPDATES -------------------------------------------------------
+
+// Displays using an FR pin. An interrupt handler takes no argument, so
+// each slot has its own, which passes the edge on to that slot's display.
+#define FR_SLOTS 4
+static Adafruit_SSD1322 *fr_displays[FR_SLOTS];
+
+void ssd1322_fr_interrupt(uint8_t slot)
+{
+	Adafruit_SSD1322 *display = fr_displays[slot];
+	if (display) {
+		uint32_t now = micros();
+		display->fr_period = now - display->fr_edge;
+		display->fr_edge = now;
+	}
+}
+
+static void fr_interrupt0() { ssd1322_fr_interrupt(0); }
+static void fr_interrupt1() { ssd1322_fr_interrupt(1); }
+static void fr_interrupt2() { ssd1322_fr_interrupt(2); }
+static void fr_interrupt3() { ssd1322_fr_interrupt(3); }
+
+static void (*const fr_interrupts[FR_SLOTS])(void) = {
+	fr_interrupt0, fr_interrupt1, fr_interrupt2, fr_interrupt3};
+
+/*!
+    @brief  Have display() hold each update back until it can be written
+            without tearing: every row is written after the panel has
+            scanned it and before it comes round again, so each refresh
+            shows either all of the old frame or all of the new one.
+    @param  enable
+            true to time updates to the panel's refresh
+    @param  fr_pin
+            Pin (using Arduino pin numbering) wired to the controller's FR
+            output, which pulses at the start of every frame, or -1 if it
+            isn't connected. It must be able to take an interrupt.
+    @return true, or false if fr_pin can't take an interrupt or four
+            other displays already use FR pins.
+    @note   Without the FR pin, how often the panel refreshes is known (see
+            getRefreshPeriod()) but not when, so updates are only locked to
+            the refresh period. Any tear then stays in one place instead of
+            crawling through the picture. Up to four displays at a time
+            can use an FR pin. displayAsync() isn't timed, and neither is
+            Adafruit_SSD1322_Group::display(), which interleaves its
+            panels' writes.
+*/
+bool Adafruit_SSD1322::enableVsync(bool enable, int8_t fr_pin)
+{
+	if (this->fr_pin >= 0) {
+		detachInterrupt(digitalPinToInterrupt(this->fr_pin));
+		fr_displays[fr_slot] = NULL;
+		fr_slot = -1;
+		this->fr_pin = -1;
+	}
+	vsync = false;
+	if (!enable) {
+		return true;
+	}
+
+	if (fr_pin >= 0) {
+		int interrupt = digitalPinToInterrupt(fr_pin);
+		if (interrupt < 0) {
+			return false;
+		}
+		int8_t slot = 0;
+		while ((slot < FR_SLOTS) && fr_displays[slot]) {
+			slot++;
+		}
+		if (slot == FR_SLOTS) {
+			return false;
+		}
+		pinMode(fr_pin, INPUT);
+		fr_edge = micros();
+		fr_period = 0;
+		fr_displays[slot] = this;
+		fr_slot = slot;
+		attachInterrupt(interrupt, fr_interrupts[slot], RISING);
+		this->fr_pin = fr_pin;
+	}
+	vsync_anchor = micros();
+	vsync = true;
+	return true;
+}
+
+/*!
+    @brief  Give the panel's actual refresh rate, e.g. as measured on the
+            FR pin with a scope, in place of the estimate made from the
+            clock settings.
+    @param  hz
+            Refreshes per second, or 0 to go back to the estimate.
+*/
+void Adafruit_SSD1322::setRefreshRate(float hz)
+{
+	refresh_period = (hz > 0) ? uint32_t(1000000.0f / hz + 0.5f) : 0;
+}
+
+/*!
+    @brief  Get the time the panel takes to refresh once. This is the rate
+            given to setRefreshRate() if any, otherwise the rate measured
+            on the FR pin if enableVsync() was given one, otherwise an
+            estimate from the controller's clock settings.
+    @return Refresh period in microseconds.
+*/
+uint32_t Adafruit_SSD1322::getRefreshPeriod(void)
+{
+	if (refresh_period) {
+		return refresh_period;
+	}
+	if (fr_pin >= 0) {
+		noInterrupts();
+		uint32_t period = fr_period;
+		interrupts();
+		// Nothing slower than 10 Hz is a refresh; the panel was off, or
+		// only one edge has been seen so far.
+		if (period && (period < 100000UL)) {
+			return period;
+		}
+	}
+	return estimate_refresh_period();
+}
+
+// Estimate the refresh period (us) from the clock settings, as
+// Ffrm = Fosc / (D * K * MUX): D is the clock divider, K the number of
+// display clocks per row and MUX the number of rows scanned.
+uint32_t Adafruit_SSD1322::estimate_refresh_period()
+{
+	uint8_t oscillator = display_clock >> 4;
+	uint8_t divider = display_clock & 0x0F;
+	if (is_ssd1322()) {
+		// Fosc runs from about 1.75 MHz to 3 MHz over its 16 settings, and D
+		// is 2^divider. A row takes the two phases set in init_controller()
+		// (5 and 14 clocks), 10 more, and the longest gray level pulse.
+		float fosc_khz = 1750 + 1250.0f * oscillator / 15;
+		uint16_t row_clocks = 5 + 14 + 10 + gray_top;
+		return uint32_t(float(1UL << divider) * row_clocks * scan_rows() * 1000 / fosc_khz);
+	}
+	// The SH1122 example code gives 80 Hz for the 0x90 used here, with all
+	// 64 rows. Each oscillator step moves Fosc by 5% of the nominal
+	// frequency (step 5), and D is divider + 1.
+	return 12500UL * 120 / (75 + 5 * oscillator) * (divider + 1) * scan_rows() / 64;
+}
+
+// Number of rows the panel scans each refresh.
+uint16_t Adafruit_SSD1322::scan_rows()
+{
+	// A partial display strip cuts the SH1122's multiplex ratio, but the
+	// SSD1322 keeps scanning every row.
+	return (partial_rows && !is_ssd1322()) ? partial_rows : HEIGHT;
+}
+
+// Position of a frame buffer row in the panel's scan, from 0 for the first
+// row scanned in each refresh.
+int16_t Adafruit_SSD1322::scan_index(int16_t row)
+{
+	if (partial_rows && !is_ssd1322()) {
+		row -= band_y1;
+	}
+	return flipped ? scan_rows() - 1 - row : row;
+}
+
+/*!
+    @brief  Wait until the dirty rows can all be written behind the panel's
+            scan. The scan reaches row r at r * T / M into each refresh (T
+            the refresh period, M the rows scanned), and row r has to be
+            written after that, but before the next refresh gets there.
+            Rows are written in scan order at an estimated w per row from
+            the bus cost model, starting s into a refresh, so for each row
+                r * T / M  <  s + (r - first) * w  <  T + r * T / M
+            Checking the first and last rows gives the earliest and latest
+            s: a write slower than the scan follows right behind it, and a
+            faster one is held back so that it catches up at the last row.
+*/
+void Adafruit_SSD1322::wait_for_scan()
+{
+	// Put the rectangles in scan order.
+	for (uint8_t i = 1; i < dirty_count; i++) {
+		dirty_rect r = dirty[i];
+		int16_t key = min(scan_index(r.y1), scan_index(r.y2));
+		uint8_t j = i;
+		while ((j > 0) && (min(scan_index(dirty[j - 1].y1), scan_index(dirty[j - 1].y2)) > key)) {
+			dirty[j] = dirty[j - 1];
+			j--;
+		}
+		dirty[j] = r;
+	}
+
+	// First and last rows in scan order, and the time to write them all.
+	int16_t first = 0x7FFF;
+	int16_t last = -1;
+	uint32_t cost = 0;
+	for (uint8_t i = 0; i < dirty_count; i++) {
+		int16_t a = scan_index(dirty[i].y1);
+		int16_t b = scan_index(dirty[i].y2);
+		first = min(first, min(a, b));
+		last = max(last, max(a, b));
+		cost += dirty_cost(dirty[i]);
+		if (flipped) {
+			// Reversed rows are addressed one at a time; see write_window().
+			cost += uint32_t(dirty[i].y2 - dirty[i].y1 + 1) * address_cost();
+		}
+	}
+	uint32_t period = getRefreshPeriod();
+	if ((last < 0) || !period) {
+		return;
+	}
+
+	// Earliest and latest start (us into a refresh), less a row either side
+	// for the estimates being out.
+	float row_scan = float(period) / scan_rows();
+	float row_write = cost / 1000.0f / (last - first + 1);
+	float lead = last * row_scan - (last - first) * row_write;
+	uint32_t earliest = uint32_t(max(first * row_scan, lead) + row_scan);
+	uint32_t latest = uint32_t(period + min(first * row_scan, lead) - row_scan);
+
+	uint32_t anchor = vsync_anchor;
+	if (fr_pin >= 0) {
+		noInterrupts();
+		anchor = fr_edge;
+		interrupts();
+	}
+	uint32_t phase = (micros() - anchor) % period;
+	if ((latest > earliest) &&
+		(((phase >= earliest) && (phase < latest)) || (phase + period < latest))) {
+		return;
+	}
+	// Too late (or the update can't keep behind the scan at all, in which
+	// case starting at the earliest point tears least); wait for the next
+	// refresh.
+	uint32_t wait = (earliest + period - phase) % period;
+	uint32_t from = micros();
+	while (micros() - from < wait) {
+		yield();
 	}
 }
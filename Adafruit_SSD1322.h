@@ -20,8 +20,130 @@ BSD license, check license.txt for more information
 All text above, and the splash screen must be included in any redistribution
 *********************************************************************/
 
+#ifndef _Adafruit_SSD1322_H_
+#define _Adafruit_SSD1322_H_
+
 #include <Adafruit_GrayOLED.h>
 
+// Maximum number of separate dirty rectangles tracked between calls to
+// display(). Once the list is full, the pair that is cheapest to combine
+// gets merged.
+#ifndef SSD1322_MAX_DIRTY_RECTS
+#define SSD1322_MAX_DIRTY_RECTS 8
+#endif
+
+// Send asynchronous display updates with the core's non-blocking SPI
+// transfers where there are any: DMA on Adafruit's SAMD core and the
+// RP2040 (Arduino-Pico) core, and a worker task on the ESP32, whose core
+// only has blocking transfers. Define this as 0 to always use the
+// cooperative fallback below.
+#ifndef SSD1322_ASYNC_DMA
+#if defined(ARDUINO_SAMD_ADAFRUIT) ||                                          \
+    (defined(ARDUINO_ARCH_RP2040) && !defined(ARDUINO_ARCH_MBED)) ||           \
+    defined(ARDUINO_ARCH_ESP32)
+#define SSD1322_ASYNC_DMA 1
+#else
+#define SSD1322_ASYNC_DMA 0
+#endif
+#endif
+
+// Approximate number of bytes sent per isBusy() call while an asynchronous
+// display update is in progress, on buses without non-blocking transfers.
+#ifndef SSD1322_ASYNC_CHUNK
+#define SSD1322_ASYNC_CHUNK 256
+#endif
+
+// Shortest run of identical bytes (in a row, or across whole rows of a
+// full-width window) that is sent as a constant fill rather than read out
+// of the frame buffer.
+#ifndef SSD1322_FILL_RUN
+#define SSD1322_FILL_RUN 16
+#endif
+
+// Number of buckets in the update time histogram kept by enableStats().
+// Bucket i counts updates that took under 2^i ms, and the last bucket
+// counts everything slower.
+#ifndef SSD1322_STATS_BUCKETS
+#define SSD1322_STATS_BUCKETS 8
+#endif
+
+// Settings used by setIdleTimeouts() while nothing is changing: the SSD1322
+// master current while dimmed, and the display clocks (divider in the low
+// nibble, oscillator in the high one) once slowed down, here about half the
+// usual frame rate.
+#ifndef SSD1322_IDLE_MASTERCURRENT
+#define SSD1322_IDLE_MASTERCURRENT 0x07
+#endif
+#ifndef SSD1322_IDLE_DCLK
+#define SSD1322_IDLE_DCLK 0x92
+#endif
+#ifndef SH1122_IDLE_DISPLAY_CLOCK
+#define SH1122_IDLE_DISPLAY_CLOCK 0x91
+#endif
+
+// With software SPI, boards that have direct port access bitbang the bus
+// straight through the port registers, which is many times faster than
+// Adafruit_SPIDevice. Define this as 0 to go through Adafruit_SPIDevice.
+#ifndef SSD1322_FAST_SOFT_SPI
+#define SSD1322_FAST_SOFT_SPI 1
+#endif
+
+// Shortest time in nanoseconds that the bitbanged clock is held high or
+// low, which keeps fast cores within the controllers' 10 MHz serial clock.
+#ifndef SSD1322_SOFT_SPI_NS
+#define SSD1322_SOFT_SPI_NS 50
+#endif
+
+// Wait at least ns nanoseconds between bus edges: delayNanoseconds() on
+// Teensy, elsewhere a loop of at least as many CPU cycles, rounded up from
+// F_CPU. Where an edge takes longer than the wait anyway (AVR at 16 MHz),
+// this comes to a cycle or two. Define it to use a board's own delay.
+#ifndef SSD1322_BUS_DELAY
+#if defined(TEENSYDUINO)
+#define SSD1322_BUS_DELAY(ns) delayNanoseconds(ns)
+#elif defined(F_CPU)
+#define SSD1322_BUS_DELAY(ns)                                                  \
+  ssd1322_spin(uint32_t((uint64_t(ns) * (F_CPU / 1000UL) + 999999UL) / 1000000UL))
+#else
+#define SSD1322_BUS_DELAY(ns) delayMicroseconds(1)
+#endif
+#endif
+
+// Spin for at least cycles CPU cycles.
+static inline void ssd1322_spin(uint32_t cycles) {
+  while (cycles--) {
+    __asm__ __volatile__("nop");
+  }
+}
+
+// Projects that only ever drive one kind of controller can define
+// SSD1322_FIXED_VARIANT in their build flags (0 for the SSD1322, 1 for the
+// SH1122). The variant checks in the drawing and flush paths then become
+// compile-time constants, and code for the other controller is dropped.
+
+class Adafruit_SSD1322_Group;
+class Adafruit_SSD1322_Canvas;
+struct Adafruit_SSD1322_Layer;
+
+/*!
+    A bus other than SPI for the display to be driven over, such as
+    Adafruit_SSD1322_Parallel. Every group of writes is bracketed by
+    select(true) and select(false), and setDataMode() is only called when
+    the level of the D/C line has to change.
+*/
+class Adafruit_SSD1322_Transport {
+public:
+  virtual ~Adafruit_SSD1322_Transport() {}
+  // Set up the pins, from Adafruit_SSD1322::begin()
+  virtual bool begin(void) = 0;
+  // Select (true) or deselect the display
+  virtual void select(bool active) = 0;
+  // Drive the D/C line: true for data, false for commands
+  virtual void setDataMode(bool data) = 0;
+  virtual void write(const uint8_t *data, size_t count) = 0;
+  // Write the same byte count times
+  virtual void fill(uint8_t value, size_t count);
+};
 
 /*! The controller object for SSD1322 OLED displays */
 class Adafruit_SSD1322 : public Adafruit_GrayOLED {
@@ -31,29 +153,403 @@ public:
     VARIANT_SSH1122
   };
 
+  /*! Power saving stages reached by setIdleTimeouts() */
+  enum {
+    IDLE_ACTIVE,
+    IDLE_DIM,
+    IDLE_SLOW,
+    IDLE_SLEEP
+  };
+
+  /*! Numbers collected about display updates once enableStats() is called */
+  struct Stats {
+    // Updates sent, and updates put off by setMaxFrameRate()
+    uint32_t frames;
+    uint32_t skipped;
+    // Traffic for the last update: bytes (commands included), display RAM
+    // windows addressed, commands and DC pin changes
+    uint32_t bytes;
+    uint16_t windows;
+    uint16_t commands;
+    uint16_t dc_toggles;
+    // Time taken by the last update, from start to the last byte sent
+    uint32_t micros;
+    // Rolling average of updates per second
+    float fps;
+    // Number of updates by time taken; see SSD1322_STATS_BUCKETS
+    uint32_t histogram[SSD1322_STATS_BUCKETS];
+  };
+
   Adafruit_SSD1322(int8_t mosi_pin, int8_t sclk_pin,
                    int8_t dc_pin, int8_t rst_pin, int8_t cs_pin, int8_t variant = VARIANT_SSD1322);
   Adafruit_SSD1322(SPIClass *spi, int8_t dc_pin,
                    int8_t rst_pin, int8_t cs_pin, int8_t variant = VARIANT_SSD1322, uint32_t bitrate = 8000000UL);
+  Adafruit_SSD1322(Adafruit_SSD1322_Transport *transport, int8_t rst_pin = -1,
+                   int8_t variant = VARIANT_SSD1322);
+  Adafruit_SSD1322(uint16_t w, uint16_t h, Adafruit_SSD1322_Transport *transport,
+                   int8_t rst_pin = -1, int8_t variant = VARIANT_SSD1322);
+  Adafruit_SSD1322(uint16_t w, uint16_t h, int8_t mosi_pin, int8_t sclk_pin,
+                   int8_t dc_pin, int8_t rst_pin, int8_t cs_pin, int8_t variant = VARIANT_SSD1322);
+  Adafruit_SSD1322(uint16_t w, uint16_t h, SPIClass *spi, int8_t dc_pin,
+                   int8_t rst_pin, int8_t cs_pin, int8_t variant = VARIANT_SSD1322, uint32_t bitrate = 8000000UL);
   ~Adafruit_SSD1322(void);
 
   bool begin(bool reset = true);
   void display();
+  void clearDisplay(void);
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  uint8_t getPixel(int16_t x, int16_t y);
   void invertDisplay(bool i);
+  void oled_command(uint8_t c);
+  bool oled_commandList(const uint8_t *c, uint8_t n);
+
+  // Rotation, optionally with the controller doing 180 degrees of it
+  void setRotation(uint8_t r);
+  void setHardwareFlip(bool enable = true);
 
   // Slightly different from the default implementation in the superclass --
   // range is from 0x00 to 0xFF
   void setContrast(uint8_t level);
 
+  // Gray levels: the panel's gray scale table (SSD1322 only), and the curve
+  // used to map 8-bit luminance onto the 16 levels. setGrayTableGamma()
+  // returns false for a gamma of 0 or less.
+  bool setGrayTable(const uint8_t table[15]);
+  bool setGrayTableGamma(float gamma);
+  void setDefaultGrayTable(void);
+  bool setLuminanceGamma(float gamma);
+  uint8_t luminanceToGray(uint8_t luminance);
+
+  // Power saving while the picture doesn't change, and burn-in protection
+  void setIdleTimeouts(uint16_t dim_seconds, uint16_t slow_seconds = 0,
+                       uint16_t sleep_seconds = 0, uint8_t dim_contrast = 0x10);
+  uint8_t getIdleStage(void) const { return idle_stage; }
+  void wake(void);
+  void setPixelShift(uint8_t rows, uint16_t seconds = 60);
+
+  bool enableShadowBuffer(bool enable = true);
+
+  // Update statistics and frame rate limiting
+  bool enableStats(bool enable = true);
+  const Stats *getStats(void) const { return stats; }
+  void setMaxFrameRate(uint16_t fps, bool wait = false);
+
+  // Tear-free updates, timed to the panel's own refresh
+  bool enableVsync(bool enable = true, int8_t fr_pin = -1);
+  void setRefreshRate(float hz);
+  uint32_t getRefreshPeriod(void);
+
+  // Double-buffered, non-blocking updates
+  bool enableAsyncDisplay(bool enable = true);
+  void displayAsync();
+  bool isBusy();
+  void waitForDisplay();
+
+  // Rendering in horizontal bands, for boards without the RAM for a whole
+  // frame buffer
+  bool beginBanded(uint8_t rows, bool reset = true);
+  void renderBands(void (*draw)(Adafruit_SSD1322 &display, void *context),
+                   void *context = NULL);
+
+  // Hardware vertical scrolling
+  void scrollVertical(int16_t rows);
+
+  // Showing only a strip of rows, e.g. a status bar, with a frame buffer
+  // for just that strip
+  bool enablePartialDisplay(int16_t y, uint8_t rows);
+  bool disablePartialDisplay(void);
+  uint8_t getPartialRows(void) const { return partial_rows; }
+
+  // Compositing offscreen canvases (see Adafruit_SSD1322_Canvas.h)
+  void compositeLayers(const Adafruit_SSD1322_Layer layers[], uint8_t count);
+
+  // Byte-wide versions of the GFX fill primitives
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillScreen(uint16_t color);
+
+  // 1bpp bitmap and text rendering straight into the 4bpp buffer
+  using Adafruit_GFX::drawBitmap;
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                  int16_t h, uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                  int16_t h, uint16_t color, uint16_t bg);
+  void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h,
+                  uint16_t color);
+  void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h,
+                  uint16_t color, uint16_t bg);
+  size_t write(uint8_t c);
+  using Print::write;
+  void drawText(int16_t x, int16_t y, const char *str);
+
+  // Grayscale images. 4bpp images are packed two pixels per byte, left
+  // pixel in the high nibble, with each row padded to a whole byte.
+  void drawGrayBitmap4(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                       int16_t h);
+  void drawGrayBitmap4(int16_t x, int16_t y, uint8_t *bitmap, int16_t w,
+                       int16_t h);
+  void drawGrayBitmap8(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                       int16_t h, bool dither = false);
+  void drawGrayBitmap8(int16_t x, int16_t y, uint8_t *bitmap, int16_t w,
+                       int16_t h, bool dither = false);
+  bool streamGrayBitmap4(int16_t x, int16_t y, const uint8_t bitmap[],
+                         int16_t w, int16_t h);
+  bool streamGrayImage4(int16_t x, int16_t y, int16_t w, int16_t h,
+                        size_t (*read)(uint8_t *data, size_t count,
+                                       void *context),
+                        void *context);
+
+  // Run-length compressed 4bpp images and animations, as made by
+  // tools/rle_encode.py. The format is described at drawRLEImage().
+  bool drawRLEImage(int16_t x, int16_t y, const uint8_t image[],
+                    uint16_t frame = 0);
+  bool streamRLEImage(int16_t x, int16_t y, const uint8_t image[],
+                      uint16_t frame = 0);
+  static uint16_t getRLEFrames(const uint8_t image[]);
+
+  // Each outermost startWrite()/endWrite() pair (i.e. each GFX drawing call)
+  // becomes its own dirty rectangle.
+  void startWrite(void);
+  void endWrite(void);
+
 private:
+  friend class Adafruit_SSD1322_Group;
+  friend class Adafruit_SSD1322_Canvas;
+
   int8_t page_offset = 0;
   int8_t column_offset = 0;
   int8_t variant;
+
+  // Hardware SPI bus, or NULL when bitbanging
+  SPIClass *spi_bus = NULL;
+  // Bus used instead of SPI, if given to the constructor
+  Adafruit_SSD1322_Transport *transport = NULL;
+  // Bitbanged SPI pins, or -1 with hardware SPI
+  int8_t mosiPin = -1;
+  int8_t sclkPin = -1;
+  // True when bitbanged SPI goes through the port registers below.
+  bool fast_soft_spi = false;
+
+  // Nesting depth of begin_batch()/end_batch(), and the last level written
+  // to the DC pin inside the current batch (-1 if unknown).
+  uint8_t batch_depth = 0;
+  int8_t dc_state = -1;
+  // Set by Adafruit_SSD1322_Group while it holds one bus transaction for
+  // several panels, so that batches only need to move this panel's CS pin.
+  bool shared_transaction = false;
+#if defined(BUSIO_USE_FAST_PINIO)
+  BusIO_PortReg *dcPort = NULL;
+  BusIO_PortMask dcPinMask = 0;
+  BusIO_PortReg *csPort = NULL;
+  BusIO_PortMask csPinMask = 0;
+  BusIO_PortReg *mosiPort = NULL;
+  BusIO_PortMask mosiPinMask = 0;
+  BusIO_PortReg *clkPort = NULL;
+  BusIO_PortMask clkPinMask = 0;
+#endif
+
+  struct dirty_rect {
+    int16_t x1, y1, x2, y2;
+  };
+  dirty_rect dirty[SSD1322_MAX_DIRTY_RECTS];
+  uint8_t dirty_count = 0;
+  uint8_t write_depth = 0;
+
+  // Copy of what was last sent to display RAM, if enabled.
+  uint8_t *shadow = NULL;
+  bool shadow_valid = false;
+
+  // Snapshot of the frame being sent by displayAsync(), and the windows
+  // (in controller column units) still to be sent from it.
+  uint8_t *back = NULL;
+  dirty_rect async_windows[SSD1322_MAX_DIRTY_RECTS];
+  uint8_t async_count = 0;
+  uint8_t async_index = 0;
+  uint16_t async_row = 0;
+  uint16_t async_last = 0;
+  bool async_start_line = false;
+  // True while the hardware sends rows of the update in the background,
+  // inside a batch that stays open until it is done.
+  bool async_dma = false;
+#if SSD1322_ASYNC_DMA && defined(ARDUINO_ARCH_ESP32)
+  // Task that runs the blocking transfers on the ESP32, and its job (the
+  // count drops to 0 when the job is done).
+  TaskHandle_t dma_task = NULL;
+  const uint8_t *dma_data = NULL;
+  volatile size_t dma_count = 0;
+  static void dma_worker(void *arg);
+#endif
+
+  // Luminance to gray level (in 1/16ths) table, or NULL for linear.
+  uint8_t *luminance_lut = NULL;
+
+  // Statistics, if enabled, and frame pacing for setMaxFrameRate(). The
+  // start and length of the last update are tracked either way.
+  Stats *stats = NULL;
+  uint32_t frame_interval = 0;
+  uint32_t frame_period = 0;
+  bool frame_wait = false;
+  uint32_t frame_start = 0;
+  uint32_t frame_length = 0;
+
+  // Tear-free updates: whether display() waits for the panel's scan, the
+  // FR pin (or -1), the refresh period (us) given to setRefreshRate() (0 to
+  // estimate it), and the time the estimate is locked to without FR.
+  bool vsync = false;
+  int8_t fr_pin = -1;
+  uint32_t refresh_period = 0;
+  uint32_t vsync_anchor = 0;
+  // micros() at the last rising edge on the FR pin and the time between the
+  // last two edges, kept up by the interrupt handler in slot fr_slot.
+  volatile uint32_t fr_edge = 0;
+  volatile uint32_t fr_period = 0;
+  int8_t fr_slot = -1;
+  friend void ssd1322_fr_interrupt(uint8_t slot);
+  // Display clock setting last sent, and the top entry of the gray scale
+  // table, which together set the refresh rate.
+  uint8_t display_clock = 0;
+  uint8_t gray_top = 180;
+
+  // Bus cost model used to choose how to flush each window: time (ns) per
+  // byte written, and extra time per command for the DC pin changes and
+  // call overhead. Measured in begin(), and adjusted while stats are enabled.
+  uint32_t cost_byte = 1000;
+  uint32_t cost_command = 1000;
+
+  // Display RAM row shown at the top of the panel, and whether the
+  // controller still needs to be told about a change to it.
+  uint8_t start_line = 0;
+  bool start_line_pending = false;
+
+  // Contrast set by setContrast(), which dimming falls back to.
+  uint8_t contrast = 0x80;
+
+  // Idle power saving: seconds without an update before each of the
+  // IDLE_DIM, IDLE_SLOW and IDLE_SLEEP stages (0 to skip one), the stage
+  // reached, and when the last update started (millis()). wake_display is
+  // set while the panel is still off, waiting for the first update after
+  // sleeping to be written.
+  uint16_t idle_seconds[3] = {0, 0, 0};
+  uint8_t idle_stage = IDLE_ACTIVE;
+  uint8_t dim_contrast = 0x10;
+  uint32_t last_update = 0;
+  bool wake_display = false;
+
+  // Pixel shift: largest display offset in rows, seconds per step, when the
+  // last step was taken (millis()), and the step, counting up and down.
+  uint8_t shift_rows = 0;
+  uint16_t shift_seconds = 0;
+  uint32_t shift_time = 0;
+  uint8_t shift_step = 0;
+
+  // Whether setHardwareFlip() allows the controller to turn the picture
+  // upside down, and whether it currently does (rotations 2 and 3).
+  bool hardware_flip = false;
+  bool flipped = false;
+
+  // Frame rows (inclusive) currently held in buffer: the whole screen, in
+  // band mode (band_rows != 0) the band being drawn by renderBands(), or
+  // the strip shown by enablePartialDisplay() (partial_rows != 0).
+  int16_t band_y1 = 0;
+  int16_t band_y2 = 0;
+  uint8_t band_rows = 0;
+  uint8_t partial_rows = 0;
  
+  inline bool is_sh1122() const {
+#if defined(SSD1322_FIXED_VARIANT)
+    return SSD1322_FIXED_VARIANT == VARIANT_SSH1122;
+#else
+    return variant == VARIANT_SSH1122;
+#endif
+  }
+  inline bool is_ssd1322() const { return !is_sh1122(); }
+
+  // Rotation still left for software to do once the controller has done
+  // its part.
+  inline uint8_t buffer_rotation() const {
+    return flipped ? (rotation & 1) : rotation;
+  }
+
+  // Start of a frame row in buffer, which may only hold a band of rows.
+  inline uint8_t *row_ptr(int16_t row) {
+    return buffer + (row - band_y1) * (WIDTH / 2);
+  }
+
   // internal methods
-  void start_write(uint16_t start_column, uint16_t start_row, uint16_t end_column, uint16_t end_row);
+  void init_geometry();
+  bool begin_bus(bool reset);
+  void init_controller();
+  void send_remap();
+  void send_display_clock(bool slow);
+  void send_display_offset(uint8_t rows);
+  void check_idle();
+  void leave_idle(bool defer_display_on);
+  void check_pixel_shift();
+  void clear_shift_rows();
+  void update_flip();
+  void rotate_rect(int16_t &x, int16_t &y, int16_t &w, int16_t &h);
+  static void fill_span(uint8_t *row, int16_t x1, int16_t x2, uint8_t color);
+  void blit_1bpp(int16_t x, int16_t y, const uint8_t *src, uint16_t stride,
+                 int16_t w, int16_t h, bool progmem, uint8_t fg, uint8_t bg,
+                 bool opaque);
+  void blit_1bpp_rotated(int16_t x, int16_t y, const uint8_t *src,
+                         uint16_t stride, int16_t w, int16_t h, bool progmem,
+                         uint8_t fg, uint8_t bg, bool opaque);
+  void blit_4bpp(int16_t x, int16_t y, const uint8_t *src, int16_t w,
+                 int16_t h, bool progmem);
+  void blit_8bpp(int16_t x, int16_t y, const uint8_t *src, int16_t w,
+                 int16_t h, bool progmem, bool dither);
+  uint8_t gray_level(uint8_t v, int16_t x, int16_t y, bool dither);
+  bool begin_frame(bool timed = true);
+  bool pace_frame();
+  uint32_t estimate_refresh_period();
+  uint16_t scan_rows();
+  int16_t scan_index(int16_t row);
+  void wait_for_scan();
+  void frame_begin();
+  void frame_end();
+  void flush_rect(uint8_t i);
+  void end_frame();
+  void reset_window();
+  void fold_window();
+  void add_dirty(dirty_rect r);
+  uint32_t dirty_cost(const dirty_rect &r);
+  void flush_window(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+  void window_columns(int16_t x1, int16_t x2, uint16_t rows, int16_t &start_column, int16_t &end_column);
+  void pump_async();
+  void send_async_rows();
+  void next_async_window();
+  bool dma_usable();
+  void dma_start(const uint8_t *data, size_t count);
+  bool dma_done();
+  void diff_window(int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+  void write_window(uint16_t start_column, uint16_t start_row, uint16_t end_column, uint16_t end_row);
+  uint32_t address_cost();
+  uint32_t write_cost(uint16_t columns, uint16_t rows);
+  void calibrate_costs();
+  void refine_costs();
+  uint16_t ram_rows();
+  uint16_t physical_row(uint16_t row);
+  void send_start_line();
+  void send_partial_display();
+  void clip_dirty(int16_t y1, int16_t y2);
+  void composite_area(const Adafruit_SSD1322_Layer &layer, int16_t x1, int16_t y1,
+                      int16_t x2, int16_t y2);
+  uint16_t start_write(uint16_t start_column, uint16_t start_row, uint16_t end_column, uint16_t end_row);
   void continue_write(uint16_t column, uint16_t row);
 
+  // command batching
+  void begin_batch();
+  void end_batch();
+  void set_dc(bool data);
+  void set_cs(bool active);
+#if defined(BUSIO_USE_FAST_PINIO)
+  void soft_write(const uint8_t *data, size_t count);
+  void soft_fill(uint8_t value, size_t count);
+#endif
+  void spi_write(const uint8_t *data, size_t count);
+
   // convenience methods
   void spi_command(uint8_t c);
   void spi_command(uint8_t c, uint8_t d1);
@@ -62,4 +558,8 @@ private:
   // core spi write methods
   void spi_command_data(uint8_t c, uint8_t *data, size_t count);
   void spi_data(uint8_t *data, size_t count);
+  void spi_data_runs(const uint8_t *data, size_t count);
+  void spi_fill(uint8_t value, size_t count);
 };
+
+#endif // _Adafruit_SSD1322_H_
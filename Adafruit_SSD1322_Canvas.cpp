@@ -0,0 +1,629 @@
+/*********************************************************************
+Offscreen 4bpp canvases for SSD1322/SH1122 displays. See
+Adafruit_SSD1322.cpp for the original license text.
+
+A screen built from a static background and a changing overlay would
+otherwise have to redraw both into the frame buffer every frame. Instead
+each can be drawn once into its own canvas, and compositeLayers() blends
+the stack into the frame buffer. Canvases remember which parts of them
+changed, so only those areas are blended (and then sent to the panel),
+and an untouched background costs nothing.
+
+Blending works on 32-bit words of packed pixels: the key test works on
+all eight nibbles at once, and the arithmetic modes spread the nibbles
+into byte-wide lanes, four at a time, so sums and products have room to
+overflow without spilling into their neighbours.
+*********************************************************************/
+
+#include "Adafruit_SSD1322_Canvas.h"
+
+// Bytes of a layer's rows blended per step, which bounds the stack space
+// used to realign layers at odd x positions.
+#ifndef SSD1322_COMPOSITE_CHUNK
+#define SSD1322_COMPOSITE_CHUNK 16
+#endif
+
+// CONSTRUCTOR, DESTRUCTOR -------------------------------------------------
+
+/*!
+    @brief  Constructor for an offscreen canvas.
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  buffer
+            Optional storage of ((w + 1) / 2) * h bytes, e.g. a static
+            array. If NULL, the canvas allocates its own; check
+            getBuffer() to see whether that worked.
+    @note   The canvas starts out black and dirty all over.
+*/
+Adafruit_SSD1322_Canvas::Adafruit_SSD1322_Canvas(uint16_t w, uint16_t h,
+                                                 uint8_t *buffer)
+    : Adafruit_GFX(w, h), buffer(buffer), own_buffer(buffer == NULL),
+      stride((w + 1) / 2) {
+  if (own_buffer) {
+    this->buffer = (uint8_t *)malloc(stride * h);
+  }
+  if (this->buffer) {
+    memset(this->buffer, 0, stride * h);
+  }
+  reset_window();
+  invalidate();
+}
+
+/*!
+    @brief  Destructor, which frees the buffer if the canvas allocated it.
+*/
+Adafruit_SSD1322_Canvas::~Adafruit_SSD1322_Canvas(void) {
+  if (own_buffer && buffer) {
+    free(buffer);
+  }
+}
+
+// DRAWING PRIMITIVES ------------------------------------------------------
+
+/*!
+    @brief  Set a single pixel.
+    @param  x
+            Column, 0 at left
+    @param  y
+            Row, 0 at top
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322_Canvas::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+	if (!buffer || (x < 0) || (y < 0) || (x >= width()) || (y >= height())) {
+		return;
+	}
+	int16_t w = 1;
+	int16_t h = 1;
+	rotate_rect(x, y, w, h);
+
+	uint8_t *ptr = buffer + y * stride + x / 2;
+	if (x & 1) {
+		*ptr = (*ptr & 0xF0) | (color & 0x0F);
+	} else {
+		*ptr = (*ptr & 0x0F) | ((color & 0x0F) << 4);
+	}
+	window_x1 = min(window_x1, x);
+	window_y1 = min(window_y1, y);
+	window_x2 = max(window_x2, x);
+	window_y2 = max(window_y2, y);
+}
+
+/*!
+    @brief  Read a single pixel.
+    @param  x
+            Column, 0 at left
+    @param  y
+            Row, 0 at top
+    @return Gray level, 0 to 15, or 0 outside the canvas.
+*/
+uint8_t Adafruit_SSD1322_Canvas::getPixel(int16_t x, int16_t y) const
+{
+	if (!buffer || (x < 0) || (y < 0) || (x >= width()) || (y >= height())) {
+		return 0;
+	}
+	int16_t w = 1;
+	int16_t h = 1;
+	rotate_rect(x, y, w, h);
+	uint8_t v = buffer[y * stride + x / 2];
+	return (x & 1) ? (v & 0x0F) : (v >> 4);
+}
+
+/*!
+    @brief  Draw a filled rectangle a whole byte at a time, in any rotation.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322_Canvas::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                       uint16_t color)
+{
+	if (!buffer) {
+		return;
+	}
+	if (w < 0) {
+		x += w + 1;
+		w = -w;
+	}
+	if (h < 0) {
+		y += h + 1;
+		h = -h;
+	}
+	rotate_rect(x, y, w, h);
+	int16_t x1 = max(x, int16_t(0));
+	int16_t y1 = max(y, int16_t(0));
+	int16_t x2 = min(int16_t(x + w - 1), int16_t(WIDTH - 1));
+	int16_t y2 = min(int16_t(y + h - 1), int16_t(HEIGHT - 1));
+	if ((x1 > x2) || (y1 > y2)) {
+		return;
+	}
+
+	startWrite();
+	for (int16_t row = y1; row <= y2; row++) {
+		Adafruit_SSD1322::fill_span(buffer + row * stride, x1, x2, color);
+	}
+	window_x1 = min(window_x1, x1);
+	window_y1 = min(window_y1, y1);
+	window_x2 = max(window_x2, x2);
+	window_y2 = max(window_y2, y2);
+	endWrite();
+}
+
+/*!
+    @brief  Draw a horizontal line using fillRect().
+    @param  x
+            Left end of the line
+    @param  y
+            Row of the line
+    @param  w
+            Length in pixels
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322_Canvas::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+	fillRect(x, y, w, 1, color);
+}
+
+/*!
+    @brief  Draw a vertical line using fillRect().
+    @param  x
+            Column of the line
+    @param  y
+            Top end of the line
+    @param  h
+            Length in pixels
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322_Canvas::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+	fillRect(x, y, 1, h, color);
+}
+
+/*!
+    @brief  Fill the whole canvas with one gray level.
+    @param  color
+            Gray level, 0 to 15
+*/
+void Adafruit_SSD1322_Canvas::fillScreen(uint16_t color)
+{
+	if (!buffer) {
+		return;
+	}
+	uint8_t c = color & 0x0F;
+	memset(buffer, c | (c << 4), stride * HEIGHT);
+	invalidate();
+}
+
+// Turn a rectangle in rotated coordinates (with w and h positive) into the
+// rectangle it covers in the buffer.
+void Adafruit_SSD1322_Canvas::rotate_rect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const
+{
+	int16_t t;
+	switch (rotation) {
+	case 1:
+		t = x;
+		x = WIDTH - y - h;
+		y = t;
+		t = w;
+		w = h;
+		h = t;
+		break;
+	case 2:
+		x = WIDTH - x - w;
+		y = HEIGHT - y - h;
+		break;
+	case 3:
+		t = y;
+		y = HEIGHT - x - w;
+		x = t;
+		t = w;
+		w = h;
+		h = t;
+		break;
+	}
+}
+
+// DIRTY RECTANGLE TRACKING ------------------------------------------------
+
+/*!
+    @brief  Start a GFX drawing operation. Nested operations are tracked so
+            that each outermost one becomes a single dirty rectangle.
+*/
+void Adafruit_SSD1322_Canvas::startWrite(void) {
+	write_depth++;
+}
+
+/*!
+    @brief  End a GFX drawing operation, adding the area it touched to the
+            dirty list once the outermost operation ends.
+*/
+void Adafruit_SSD1322_Canvas::endWrite(void) {
+	if (write_depth > 0) {
+		write_depth--;
+	}
+	if (write_depth == 0) {
+		fold_window();
+	}
+}
+
+/*!
+    @brief  Mark the whole canvas as changed, so the next compositeLayers()
+            blends all of it.
+*/
+void Adafruit_SSD1322_Canvas::invalidate(void)
+{
+	reset_window();
+	dirty_count = 0;
+	area all = {0, 0, int16_t(WIDTH - 1), int16_t(HEIGHT - 1)};
+	add_area(dirty, dirty_count, SSD1322_CANVAS_DIRTY_RECTS, all);
+}
+
+/*!
+    @brief  Check whether anything has been drawn since the canvas was last
+            composited.
+    @return true if the canvas has dirty areas.
+*/
+bool Adafruit_SSD1322_Canvas::isDirty(void) const
+{
+	return (dirty_count != 0) || (window_x1 <= window_x2);
+}
+
+/*!
+    @brief  Forget about any changes, e.g. after compositing the canvas some
+            other way.
+*/
+void Adafruit_SSD1322_Canvas::clearDirty(void)
+{
+	reset_window();
+	dirty_count = 0;
+}
+
+void Adafruit_SSD1322_Canvas::reset_window(void)
+{
+	window_x1 = 0x7FFF;
+	window_y1 = 0x7FFF;
+	window_x2 = -1;
+	window_y2 = -1;
+}
+
+// Move the window drawn since the last endWrite() into the dirty list.
+void Adafruit_SSD1322_Canvas::fold_window(void)
+{
+	if ((window_x1 <= window_x2) && (window_y1 <= window_y2)) {
+		area r = {window_x1, window_y1, window_x2, window_y2};
+		add_area(dirty, dirty_count, SSD1322_CANVAS_DIRTY_RECTS, r);
+	}
+	reset_window();
+}
+
+// Add a rectangle to a list of up to limit areas. Anything it overlaps or
+// touches is merged into it, so the areas in the list never overlap and
+// each one is only blended once. When the list is full, the two areas
+// whose union adds the fewest pixels are merged.
+void Adafruit_SSD1322_Canvas::add_area(area list[], uint8_t &count, uint8_t limit, area r)
+{
+	bool merged;
+	do {
+		merged = false;
+		for (uint8_t i = 0; i < count; i++) {
+			if ((list[i].x1 <= r.x2 + 1) && (r.x1 <= list[i].x2 + 1) &&
+			    (list[i].y1 <= r.y2 + 1) && (r.y1 <= list[i].y2 + 1)) {
+				r.x1 = min(r.x1, list[i].x1);
+				r.y1 = min(r.y1, list[i].y1);
+				r.x2 = max(r.x2, list[i].x2);
+				r.y2 = max(r.y2, list[i].y2);
+				list[i] = list[--count];
+				merged = true;
+				break;
+			}
+		}
+	} while (merged);
+
+	if (count < limit) {
+		list[count++] = r;
+		return;
+	}
+
+	uint8_t best = 0;
+	int32_t best_growth = 0x7FFFFFFF;
+	for (uint8_t i = 0; i < count; i++) {
+		int32_t w = max(r.x2, list[i].x2) - min(r.x1, list[i].x1) + 1;
+		int32_t h = max(r.y2, list[i].y2) - min(r.y1, list[i].y1) + 1;
+		int32_t growth = w * h - int32_t(list[i].x2 - list[i].x1 + 1) * (list[i].y2 - list[i].y1 + 1);
+		if (growth < best_growth) {
+			best_growth = growth;
+			best = i;
+		}
+	}
+	r.x1 = min(r.x1, list[best].x1);
+	r.y1 = min(r.y1, list[best].y1);
+	r.x2 = max(r.x2, list[best].x2);
+	r.y2 = max(r.y2, list[best].y2);
+	list[best] = list[--count];
+	// The union may now overlap others, so add it from the top.
+	add_area(list, count, limit, r);
+}
+
+// COMPOSITING -------------------------------------------------------------
+
+#define LANES 0x0F0F0F0FUL
+
+// Nibble-wise select: the layer's pixels, except where they equal the key.
+static inline uint32_t blend_key(uint32_t s, uint32_t d, uint32_t key)
+{
+	// Fold each nibble of the difference down into its lowest bit.
+	uint32_t x = s ^ key;
+	x |= x >> 1;
+	x |= x >> 2;
+	uint32_t m = (x & 0x11111111UL) * 0x0F;
+	return (s & m) | (d & ~m);
+}
+
+// The rest work on four pixels at a time, one in the low nibble of each
+// byte (lane).
+
+static inline uint32_t max_lanes(uint32_t a, uint32_t b)
+{
+	// Bit 4 of each lane of 16 + a - b is set where a >= b.
+	uint32_t m = ((((a | 0x10101010UL) - b) >> 4) & 0x01010101UL) * 0x0F;
+	return (a & m) | (b & ~m);
+}
+
+static inline uint32_t add_lanes(uint32_t a, uint32_t b)
+{
+	uint32_t t = a + b;
+	// Lanes that carried into bit 4 saturate at 15.
+	return (t | (((t >> 4) & 0x01010101UL) * 0x0F)) & LANES;
+}
+
+// Multiply each lane of v by the matching lane of a, one bit of a at a time.
+static inline uint32_t mul_lanes(uint32_t v, uint32_t a)
+{
+	uint32_t r = 0;
+	for (uint8_t b = 0; b < 4; b++) {
+		r += (v << b) & (((a >> b) & 0x01010101UL) * 0xFF);
+	}
+	return r;
+}
+
+static inline uint32_t alpha_lanes(uint32_t s, uint32_t d, uint32_t a)
+{
+	// (s * a + d * (15 - a)) / 15, rounded. Dividing a lane t of up to
+	// 233 by 15 is (t + t / 16) / 16.
+	uint32_t t = mul_lanes(s, a) + mul_lanes(d, a ^ LANES) + 0x08080808UL;
+	return ((t + ((t >> 4) & LANES)) >> 4) & LANES;
+}
+
+// Blend n bytes of a layer (and its alpha) into the frame buffer.
+static void blend_bytes(uint8_t *dst, const uint8_t *src, const uint8_t *alpha,
+                        uint8_t n, uint8_t mode, uint8_t value)
+{
+	if (mode == SSD1322_BLEND_COPY) {
+		memcpy(dst, src, n);
+		return;
+	}
+
+	uint32_t key = (value & 0x0F) * 0x11111111UL;
+	uint32_t level = (value & 0x0F) * 0x01010101UL;
+	for (uint8_t k = 0; k < n; k += 4) {
+		// A short last word is padded with zeros, and only its real bytes stored.
+		uint8_t c = min(uint8_t(4), uint8_t(n - k));
+		uint32_t s = 0;
+		uint32_t d = 0;
+		memcpy(&s, src + k, c);
+		memcpy(&d, dst + k, c);
+		uint32_t r;
+		switch (mode) {
+		case SSD1322_BLEND_KEY:
+			r = blend_key(s, d, key);
+			break;
+		case SSD1322_BLEND_MAX:
+			r = max_lanes(s & LANES, d & LANES) |
+			    (max_lanes((s >> 4) & LANES, (d >> 4) & LANES) << 4);
+			break;
+		case SSD1322_BLEND_ADD:
+			r = add_lanes(s & LANES, d & LANES) |
+			    (add_lanes((s >> 4) & LANES, (d >> 4) & LANES) << 4);
+			break;
+		default: {
+			uint32_t a_lo = level;
+			uint32_t a_hi = level;
+			if (alpha) {
+				uint32_t a = 0;
+				memcpy(&a, alpha + k, c);
+				a_lo = a & LANES;
+				a_hi = (a >> 4) & LANES;
+			}
+			r = alpha_lanes(s & LANES, d & LANES, a_lo) |
+			    (alpha_lanes((s >> 4) & LANES, (d >> 4) & LANES, a_hi) << 4);
+			break;
+		}
+		}
+		memcpy(dst + k, &r, c);
+	}
+}
+
+// Get n bytes of a canvas row lined up with the frame buffer, starting with
+// canvas pixel px in the high nibble. If px is even they can be used where
+// they are; otherwise every pixel moves to the other nibble, via tmp.
+// Pixels outside the row read as 0.
+static const uint8_t *layer_bytes(const uint8_t *row, uint16_t stride, int16_t px,
+                                  uint8_t n, uint8_t *tmp)
+{
+	if (!(px & 1)) {
+		return row + px / 2;
+	}
+	// Byte holding pixel px in its low nibble.
+	int16_t i = (px - 1) / 2;
+	uint8_t prev = (i >= 0) ? row[i] : 0;
+	for (uint8_t k = 0; k < n; k++) {
+		i++;
+		uint8_t next = (i < int16_t(stride)) ? row[i] : 0;
+		tmp[k] = (prev << 4) | (next >> 4);
+		prev = next;
+	}
+	return tmp;
+}
+
+/*!
+    @brief  Blend a stack of offscreen canvases into the frame buffer,
+            bottom layer first. Only the areas where any layer has changed
+            since the last call are blended, and they become the dirty
+            rectangles for the next display().
+    @param  layers
+            The layers, bottom first. The bottom layer is normally a
+            full-screen SSD1322_BLEND_COPY layer, so that each changed area
+            is rebuilt from scratch rather than blended onto itself.
+    @param  count
+            Number of layers
+    @note   Each canvas remembers where it was last composited, so moving
+            a layer redraws both its old and its new place; nothing needs
+            to be invalidated for it. A canvas should only be in one layer.
+    @note   In band mode (beginBanded()), the whole of the current band is
+            blended every time, since it is drawn from scratch.
+*/
+void Adafruit_SSD1322::compositeLayers(const Adafruit_SSD1322_Layer layers[], uint8_t count)
+{
+	typedef Adafruit_SSD1322_Canvas::area area;
+	area areas[SSD1322_MAX_DIRTY_RECTS];
+	uint8_t area_count = 0;
+
+	if (band_rows) {
+		area band = {0, band_y1, int16_t(WIDTH - 1), band_y2};
+		areas[area_count++] = band;
+	} else {
+		// Gather what changed in every layer (and alpha mask) in frame buffer coordinates.
+		for (uint8_t i = 0; i < count; i++) {
+			for (uint8_t m = 0; m < 2; m++) {
+				Adafruit_SSD1322_Canvas *canvas = m ? layers[i].mask : layers[i].canvas;
+				if (!canvas || (m && (layers[i].mode != SSD1322_BLEND_ALPHA))) {
+					continue;
+				}
+				canvas->fold_window();
+				if (!m && canvas->placed &&
+				    ((canvas->placed_x != layers[i].x) || (canvas->placed_y != layers[i].y))) {
+					// The layer moved: what was under its old spot shows
+					// again, and all of it is new where it is now.
+					area from = {canvas->placed_x, canvas->placed_y,
+					             int16_t(canvas->placed_x + canvas->WIDTH - 1),
+					             int16_t(canvas->placed_y + canvas->HEIGHT - 1)};
+					area to = {layers[i].x, layers[i].y,
+					           int16_t(layers[i].x + canvas->WIDTH - 1),
+					           int16_t(layers[i].y + canvas->HEIGHT - 1)};
+					Adafruit_SSD1322_Canvas::add_area(areas, area_count, SSD1322_MAX_DIRTY_RECTS, from);
+					Adafruit_SSD1322_Canvas::add_area(areas, area_count, SSD1322_MAX_DIRTY_RECTS, to);
+				}
+				for (uint8_t k = 0; k < canvas->dirty_count; k++) {
+					area r = canvas->dirty[k];
+					r.x1 += layers[i].x;
+					r.y1 += layers[i].y;
+					r.x2 += layers[i].x;
+					r.y2 += layers[i].y;
+					Adafruit_SSD1322_Canvas::add_area(areas, area_count, SSD1322_MAX_DIRTY_RECTS, r);
+				}
+			}
+		}
+	}
+
+	for (uint8_t a = 0; a < area_count; a++) {
+		int16_t x1 = max(areas[a].x1, int16_t(0));
+		int16_t y1 = max(areas[a].y1, band_y1);
+		int16_t x2 = min(areas[a].x2, int16_t(WIDTH - 1));
+		int16_t y2 = min(areas[a].y2, band_y2);
+		if ((x1 > x2) || (y1 > y2)) {
+			continue;
+		}
+
+		startWrite();
+		for (uint8_t i = 0; i < count; i++) {
+			const Adafruit_SSD1322_Canvas *canvas = layers[i].canvas;
+			if (!canvas || !canvas->buffer) {
+				continue;
+			}
+			int16_t lx1 = max(x1, layers[i].x);
+			int16_t ly1 = max(y1, layers[i].y);
+			int16_t lx2 = min(x2, int16_t(layers[i].x + canvas->WIDTH - 1));
+			int16_t ly2 = min(y2, int16_t(layers[i].y + canvas->HEIGHT - 1));
+			if ((lx1 <= lx2) && (ly1 <= ly2)) {
+				composite_area(layers[i], lx1, ly1, lx2, ly2);
+			}
+		}
+		window_x1 = min(window_x1, x1);
+		window_y1 = min(window_y1, y1);
+		window_x2 = max(window_x2, x2);
+		window_y2 = max(window_y2, y2);
+		endWrite();
+	}
+
+	for (uint8_t i = 0; i < count; i++) {
+		if (layers[i].canvas) {
+			layers[i].canvas->placed_x = layers[i].x;
+			layers[i].canvas->placed_y = layers[i].y;
+			layers[i].canvas->placed = true;
+		}
+	}
+	if (!band_rows) {
+		for (uint8_t i = 0; i < count; i++) {
+			if (layers[i].canvas) {
+				layers[i].canvas->clearDirty();
+			}
+			if (layers[i].mask) {
+				layers[i].mask->clearDirty();
+			}
+		}
+	}
+}
+
+// Blend one layer into a rectangle of the frame buffer (inclusive, and
+// inside both the layer and the buffer).
+void Adafruit_SSD1322::composite_area(const Adafruit_SSD1322_Layer &layer, int16_t x1,
+                                      int16_t y1, int16_t x2, int16_t y2)
+{
+	const Adafruit_SSD1322_Canvas *canvas = layer.canvas;
+	const Adafruit_SSD1322_Canvas *mask = NULL;
+	if ((layer.mode == SSD1322_BLEND_ALPHA) && layer.mask && layer.mask->buffer) {
+		mask = layer.mask;
+	}
+
+	int16_t first = x1 / 2;
+	int16_t bytes = x2 / 2 - first + 1;
+	// Canvas pixel that lands in the high nibble of the first byte.
+	int16_t px = first * 2 - layer.x;
+	uint8_t src_tmp[SSD1322_COMPOSITE_CHUNK];
+	uint8_t alpha_tmp[SSD1322_COMPOSITE_CHUNK];
+
+	for (int16_t y = y1; y <= y2; y++) {
+		uint8_t *dst = row_ptr(y) + first;
+		const uint8_t *src = canvas->buffer + (y - layer.y) * canvas->stride;
+		const uint8_t *alpha = mask ? mask->buffer + (y - layer.y) * mask->stride : NULL;
+		// The ends may only be half covered; put back the nibbles that aren't.
+		uint8_t head = dst[0];
+		uint8_t tail = dst[bytes - 1];
+
+		for (int16_t k = 0; k < bytes; k += SSD1322_COMPOSITE_CHUNK) {
+			uint8_t n = min(int16_t(SSD1322_COMPOSITE_CHUNK), int16_t(bytes - k));
+			const uint8_t *s = layer_bytes(src, canvas->stride, px + k * 2, n, src_tmp);
+			const uint8_t *a = alpha ? layer_bytes(alpha, mask->stride, px + k * 2, n, alpha_tmp) : NULL;
+			blend_bytes(dst + k, s, a, n, layer.mode, layer.value);
+		}
+
+		if (x1 & 1) {
+			dst[0] = (head & 0xF0) | (dst[0] & 0x0F);
+		}
+		if (!(x2 & 1)) {
+			dst[bytes - 1] = (dst[bytes - 1] & 0xF0) | (tail & 0x0F);
+		}
+	}
+}
@@ -0,0 +1,98 @@
+/*********************************************************************
+Offscreen 4bpp canvases for SSD1322/SH1122 displays, and the layers they
+are composited through. See Adafruit_SSD1322.h for the original license
+text.
+*********************************************************************/
+
+#ifndef _Adafruit_SSD1322_Canvas_H_
+#define _Adafruit_SSD1322_Canvas_H_
+
+#include "Adafruit_SSD1322.h"
+
+// Number of separate dirty rectangles an Adafruit_SSD1322_Canvas keeps
+// before merging them.
+#ifndef SSD1322_CANVAS_DIRTY_RECTS
+#define SSD1322_CANVAS_DIRTY_RECTS 4
+#endif
+
+// How a layer is combined with the layers below it
+#define SSD1322_BLEND_COPY 0  ///< Replace what's below
+#define SSD1322_BLEND_KEY 1   ///< Replace, except where the layer is the key color
+#define SSD1322_BLEND_MAX 2   ///< Keep the brighter of the two
+#define SSD1322_BLEND_ADD 3   ///< Add the gray levels, saturating at 15
+#define SSD1322_BLEND_ALPHA 4 ///< Mix by a 4-bit alpha, 15 = all layer
+
+/*!
+    An offscreen 4bpp drawing surface with the same nibble layout as the
+    display's frame buffer (two pixels per byte, left pixel in the high
+    nibble, rows padded to a whole byte). It keeps its own list of dirty
+    rectangles, so compositing only has to blend what changed.
+*/
+class Adafruit_SSD1322_Canvas : public Adafruit_GFX {
+public:
+  Adafruit_SSD1322_Canvas(uint16_t w, uint16_t h, uint8_t *buffer = NULL);
+  ~Adafruit_SSD1322_Canvas(void);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void fillScreen(uint16_t color);
+  uint8_t getPixel(int16_t x, int16_t y) const;
+
+  uint8_t *getBuffer(void) const { return buffer; }
+  uint16_t getStride(void) const { return stride; }
+
+  void startWrite(void);
+  void endWrite(void);
+
+  void invalidate(void);
+  bool isDirty(void) const;
+  void clearDirty(void);
+
+private:
+  friend class Adafruit_SSD1322;
+
+  // Rectangle with inclusive corners, in unrotated canvas coordinates.
+  struct area {
+    int16_t x1, y1, x2, y2;
+  };
+  static void add_area(area list[], uint8_t &count, uint8_t limit, area r);
+
+  void rotate_rect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const;
+  void reset_window(void);
+  void fold_window(void);
+
+  uint8_t *buffer;
+  bool own_buffer;
+  uint16_t stride;
+  area dirty[SSD1322_CANVAS_DIRTY_RECTS];
+  uint8_t dirty_count = 0;
+  // Bounds of what's been drawn since the last endWrite(), which become
+  // one dirty rectangle when the outermost endWrite() is reached.
+  int16_t window_x1, window_y1, window_x2, window_y2;
+  uint8_t write_depth = 0;
+  // Where compositeLayers() last put the canvas, so that moving its layer
+  // redraws both where it was and where it now is.
+  int16_t placed_x = 0, placed_y = 0;
+  bool placed = false;
+};
+
+/*!
+    One canvas in a stack composited by Adafruit_SSD1322::compositeLayers().
+    Layers are placed in frame buffer coordinates (those of rotation 0).
+*/
+struct Adafruit_SSD1322_Layer {
+  Adafruit_SSD1322_Canvas *canvas; ///< What to draw
+  int16_t x;                       ///< Left edge in the frame buffer
+  int16_t y;                       ///< Top edge in the frame buffer
+  uint8_t mode;                    ///< SSD1322_BLEND_*
+  /// Key color for SSD1322_BLEND_KEY, or alpha (0-15) for
+  /// SSD1322_BLEND_ALPHA without a mask
+  uint8_t value;
+  /// Per-pixel alpha for SSD1322_BLEND_ALPHA, the same size as canvas, or
+  /// NULL to use value for every pixel
+  Adafruit_SSD1322_Canvas *mask;
+};
+
+#endif // _Adafruit_SSD1322_Canvas_H_
@@ -0,0 +1,308 @@
+/*********************************************************************
+Several SSD1322/SH1122 panels tiled into one larger GFX canvas. See
+Adafruit_SSD1322.cpp for the original license text.
+
+Drawing is split up and passed to the panels, which each keep their own
+frame buffer and dirty rectangles, so each panel is only sent its share
+of what changed. When all the panels are on the same hardware SPI bus
+(each with its own CS pin), display() sends all of them inside a single
+bus transaction, taking turns between the panels one dirty rectangle at
+a time so that a big change on one panel doesn't hold up small changes
+on the others.
+*********************************************************************/
+
+#include "Adafruit_SSD1322_Group.h"
+
+// CONSTRUCTOR -------------------------------------------------------------
+
+/*!
+    @brief  Constructor for a group of panels.
+    @param  panels
+            Array of columns * rows pointers to the panels, in rows from
+            the top left, e.g. { top left, top right, bottom left, bottom
+            right } for a 2x2 grid. The panels must all be the same size.
+            Up to SSD1322_MAX_PANELS panels are used.
+    @param  columns
+            Number of panels across.
+    @param  rows
+            Number of panels down.
+    @note   Call begin() on the group rather than on the panels.
+*/
+Adafruit_SSD1322_Group::Adafruit_SSD1322_Group(Adafruit_SSD1322 **panels,
+                                               uint8_t columns, uint8_t rows)
+    : Adafruit_GFX(panels[0]->width() * columns, panels[0]->height() * rows),
+      columns(columns), rows(rows) {
+  count = min(columns * rows, SSD1322_MAX_PANELS);
+  for (uint8_t i = 0; i < count; i++) {
+    this->panels[i] = panels[i];
+  }
+  panel_width = panels[0]->width();
+  panel_height = panels[0]->height();
+}
+
+// ALLOCATE & INIT DISPLAY -------------------------------------------------
+
+/*!
+    @brief  Initialize all the panels.
+    @param  reset
+            If true, each distinct reset pin is pulsed once, so panels
+            sharing a reset line don't reset the ones initialized before
+            them.
+    @return true if every panel was initialized.
+*/
+bool Adafruit_SSD1322_Group::begin(bool reset)
+{
+	// Deselect every panel first, so none of them picks up another's init sequence.
+	for (uint8_t i = 0; i < count; i++) {
+		if (panels[i]->csPin >= 0) {
+			pinMode(panels[i]->csPin, OUTPUT);
+			digitalWrite(panels[i]->csPin, HIGH);
+		}
+	}
+
+	for (uint8_t i = 0; i < count; i++) {
+		bool first = true;
+		for (uint8_t j = 0; j < i; j++) {
+			if (panels[j]->rstPin == panels[i]->rstPin) {
+				first = false;
+			}
+		}
+		if (!panels[i]->begin(reset && first)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*!
+    @brief  Get one of the panels, e.g. to change its contrast.
+    @param  column
+            Panel column, 0 at left
+    @param  row
+            Panel row, 0 at top
+    @return The panel, or NULL if out of range.
+*/
+Adafruit_SSD1322 *Adafruit_SSD1322_Group::getPanel(uint8_t column, uint8_t row)
+{
+	uint8_t i = row * columns + column;
+	if ((column >= columns) || (i >= count)) {
+		return NULL;
+	}
+	return panels[i];
+}
+
+// DRAWING PRIMITIVES ------------------------------------------------------
+
+/*!
+    @brief  Set a single pixel.
+    @param  x
+            Column, 0 at left
+    @param  y
+            Row, 0 at top
+    @param  color
+            Gray level, 0 (off) to 15 (brightest)
+*/
+void Adafruit_SSD1322_Group::drawPixel(int16_t x, int16_t y, uint16_t color)
+{
+	if ((x < 0) || (y < 0) || (x >= width()) || (y >= height())) {
+		return;
+	}
+	int16_t t;
+	switch (getRotation()) {
+	case 1:
+		t = x;
+		x = WIDTH - y - 1;
+		y = t;
+		break;
+	case 2:
+		x = WIDTH - x - 1;
+		y = HEIGHT - y - 1;
+		break;
+	case 3:
+		t = x;
+		x = y;
+		y = HEIGHT - t - 1;
+		break;
+	}
+
+	uint8_t i = (y / panel_height) * columns + (x / panel_width);
+	if (i < count) {
+		panels[i]->drawPixel(x % panel_width, y % panel_height, color);
+	}
+}
+
+void Adafruit_SSD1322_Group::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+{
+	fillRect(x, y, w, 1, color);
+}
+
+void Adafruit_SSD1322_Group::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+{
+	fillRect(x, y, 1, h, color);
+}
+
+/*!
+    @brief  Fill a rectangle, passing each panel the part that covers it.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  color
+            Gray level, 0 (off) to 15 (brightest)
+*/
+void Adafruit_SSD1322_Group::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+{
+	if (w < 0) {
+		x += w + 1;
+		w = -w;
+	}
+	if (h < 0) {
+		y += h + 1;
+		h = -h;
+	}
+
+	// Turn the rectangle into unrotated canvas coordinates.
+	int16_t t;
+	switch (getRotation()) {
+	case 1:
+		t = x;
+		x = WIDTH - y - h;
+		y = t;
+		t = w;
+		w = h;
+		h = t;
+		break;
+	case 2:
+		x = WIDTH - x - w;
+		y = HEIGHT - y - h;
+		break;
+	case 3:
+		t = x;
+		x = y;
+		y = HEIGHT - t - w;
+		t = w;
+		w = h;
+		h = t;
+		break;
+	}
+
+	int16_t x1 = max(x, int16_t(0));
+	int16_t y1 = max(y, int16_t(0));
+	int16_t x2 = min(int16_t(x + w - 1), int16_t(WIDTH - 1));
+	int16_t y2 = min(int16_t(y + h - 1), int16_t(HEIGHT - 1));
+	if ((x1 > x2) || (y1 > y2)) {
+		return;
+	}
+
+	for (uint8_t r = y1 / panel_height; r <= y2 / panel_height; r++) {
+		int16_t top = r * panel_height;
+		for (uint8_t c = x1 / panel_width; c <= x2 / panel_width; c++) {
+			uint8_t i = r * columns + c;
+			if (i >= count) {
+				continue;
+			}
+			int16_t left = c * panel_width;
+			int16_t px1 = max(x1, left);
+			int16_t py1 = max(y1, top);
+			int16_t px2 = min(x2, int16_t(left + panel_width - 1));
+			int16_t py2 = min(y2, int16_t(top + panel_height - 1));
+			panels[i]->fillRect(px1 - left, py1 - top, px2 - px1 + 1, py2 - py1 + 1, color);
+		}
+	}
+}
+
+void Adafruit_SSD1322_Group::fillScreen(uint16_t color)
+{
+	for (uint8_t i = 0; i < count; i++) {
+		panels[i]->fillScreen(color);
+	}
+}
+
+void Adafruit_SSD1322_Group::startWrite(void)
+{
+	for (uint8_t i = 0; i < count; i++) {
+		panels[i]->startWrite();
+	}
+}
+
+void Adafruit_SSD1322_Group::endWrite(void)
+{
+	for (uint8_t i = 0; i < count; i++) {
+		panels[i]->endWrite();
+	}
+}
+
+// DISPLAY UPDATES ---------------------------------------------------------
+
+// True if every panel is on the same hardware SPI bus, so one transaction can cover them all.
+bool Adafruit_SSD1322_Group::shared_bus()
+{
+	for (uint8_t i = 0; i < count; i++) {
+		if ((panels[i]->spi_bus == NULL) || (panels[i]->spi_bus != panels[0]->spi_bus)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/*!
+    @brief  Send the dirty areas of every panel to display RAM. The panels
+            take turns, one dirty rectangle each, and panels with nothing
+            to send are skipped entirely.
+    @note   On a shared hardware SPI bus the whole update is one bus
+            transaction using the first panel's SPI settings, so all the
+            panels should be constructed with the same bitrate.
+    @note   The panels' writes are interleaved, so no panel's update can
+            be timed to its own scan; enableVsync() on a panel only times
+            that panel's own display().
+*/
+void Adafruit_SSD1322_Group::display(void)
+{
+	yield();
+
+	uint8_t turns[SSD1322_MAX_PANELS];
+	uint8_t most = 0;
+	for (uint8_t i = 0; i < count; i++) {
+		turns[i] = 0;
+		if (panels[i]->begin_frame(false)) {
+			// A panel with only a start line change still needs one turn to send it.
+			turns[i] = max(panels[i]->dirty_count, uint8_t(1));
+		}
+		most = max(most, turns[i]);
+	}
+	if (most == 0) {
+		return;
+	}
+
+	bool shared = shared_bus();
+	if (shared) {
+		panels[0]->spi_dev->beginTransaction();
+	}
+	for (uint8_t turn = 0; turn < most; turn++) {
+		for (uint8_t i = 0; i < count; i++) {
+			if (turn >= turns[i]) {
+				continue;
+			}
+			Adafruit_SSD1322 *panel = panels[i];
+			panel->shared_transaction = shared;
+			panel->begin_batch();
+			if (turn < panel->dirty_count) {
+				panel->flush_rect(turn);
+			}
+			if (turn == turns[i] - 1) {
+				panel->end_frame();
+			}
+			panel->end_batch();
+			panel->shared_transaction = false;
+		}
+	}
+	if (shared) {
+		panels[0]->spi_dev->endTransaction();
+	}
+
+	yield();
+}
@@ -0,0 +1,48 @@
+/*********************************************************************
+Several SSD1322/SH1122 panels tiled into one larger GFX canvas. See
+Adafruit_SSD1322.h for the original license text.
+*********************************************************************/
+
+#ifndef _Adafruit_SSD1322_Group_H_
+#define _Adafruit_SSD1322_Group_H_
+
+#include "Adafruit_SSD1322.h"
+
+// Maximum number of panels in one Adafruit_SSD1322_Group.
+#ifndef SSD1322_MAX_PANELS
+#define SSD1322_MAX_PANELS 8
+#endif
+
+/*! A grid of identically sized SSD1322/SH1122 panels drawn as one canvas */
+class Adafruit_SSD1322_Group : public Adafruit_GFX {
+public:
+  Adafruit_SSD1322_Group(Adafruit_SSD1322 **panels, uint8_t columns,
+                         uint8_t rows);
+
+  bool begin(bool reset = true);
+  void display();
+  Adafruit_SSD1322 *getPanel(uint8_t column, uint8_t row);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillScreen(uint16_t color);
+
+  // Passed on to every panel, so each GFX drawing call still becomes its
+  // own dirty rectangle on the panels it touches.
+  void startWrite(void);
+  void endWrite(void);
+
+private:
+  Adafruit_SSD1322 *panels[SSD1322_MAX_PANELS];
+  uint8_t columns;
+  uint8_t rows;
+  uint8_t count;
+  int16_t panel_width;
+  int16_t panel_height;
+
+  bool shared_bus();
+};
+
+#endif // _Adafruit_SSD1322_Group_H_
@@ -0,0 +1,228 @@
+/*********************************************************************
+8-bit parallel bus for SSD1322/SH1122 displays. See Adafruit_SSD1322.cpp
+for the original license text.
+
+Over SPI every byte takes eight clock cycles. With a parallel bus it is
+put on D0-D7 at once and latched with a single strobe, so a full frame
+needs a fraction of the pin changes. When the data pins are consecutive
+bits of one port, a byte is a single port write; long runs of one value
+(blank areas, see spi_fill()) leave the data lines alone and only strobe.
+*********************************************************************/
+
+#include "Adafruit_SSD1322_Parallel.h"
+
+/*!
+    @brief  Constructor for an 8-bit parallel bus.
+    @param  data_pins
+            Pins (using Arduino pin numbering) wired to D0 to D7. For the
+            fastest writes, use pins that are bits n to n + 7 of one port,
+            in order.
+    @param  strobe_pin
+            WR# for the 8080 protocol, or E for 6800.
+    @param  rw_pin
+            RD# for 8080, or R/W# for 6800, which is held at the write
+            level. -1 if it is tied on the board.
+    @param  dc_pin
+            Data/command pin (D/C#).
+    @param  cs_pin
+            Chip-select pin, or -1 if tied low. Active low.
+    @param  mode
+            SSD1322_BUS_8080 or SSD1322_BUS_6800, to match how the
+            controller's BS pins are strapped.
+*/
+Adafruit_SSD1322_Parallel::Adafruit_SSD1322_Parallel(const int8_t data_pins[8],
+                                                     int8_t strobe_pin,
+                                                     int8_t rw_pin, int8_t dc_pin,
+                                                     int8_t cs_pin, uint8_t mode)
+    : strobe_pin(strobe_pin), rw_pin(rw_pin), dc_pin(dc_pin), cs_pin(cs_pin),
+      mode(mode) {
+  memcpy(this->data_pins, data_pins, sizeof(this->data_pins));
+}
+
+/*!
+    @brief  Set up the pins, leaving the display deselected.
+    @return true, or false if a data, strobe or D/C pin is missing.
+*/
+bool Adafruit_SSD1322_Parallel::begin(void)
+{
+	if ((strobe_pin < 0) || (dc_pin < 0)) {
+		return false;
+	}
+	for (uint8_t i = 0; i < 8; i++) {
+		if (data_pins[i] < 0) {
+			return false;
+		}
+		pinMode(data_pins[i], OUTPUT);
+	}
+	pinMode(strobe_pin, OUTPUT);
+	pinMode(dc_pin, OUTPUT);
+	if (cs_pin >= 0) {
+		pinMode(cs_pin, OUTPUT);
+		digitalWrite(cs_pin, HIGH);
+	}
+	if (rw_pin >= 0) {
+		// Never read: RD# stays inactive (high), R/W# stays at write (low).
+		pinMode(rw_pin, OUTPUT);
+		digitalWrite(rw_pin, (mode == SSD1322_BUS_8080) ? HIGH : LOW);
+	}
+	// The strobe idles high for 8080 and low for 6800.
+	digitalWrite(strobe_pin, (mode == SSD1322_BUS_8080) ? HIGH : LOW);
+
+#if defined(BUSIO_USE_FAST_PINIO) && SSD1322_FAST_PARALLEL
+	for (uint8_t i = 0; i < 8; i++) {
+		data_ports[i] = (BusIO_PortReg *)portOutputRegister(digitalPinToPort(data_pins[i]));
+		data_masks[i] = digitalPinToBitMask(data_pins[i]);
+	}
+	// Whole bytes can be written at once if D0-D7 are in order on one port.
+	data_port = data_ports[0];
+	for (uint8_t i = 1; i < 8; i++) {
+		if ((data_ports[i] != data_port) || (data_masks[i] != BusIO_PortMask(data_masks[0] << i))) {
+			data_port = NULL;
+		}
+	}
+	data_shift = 0;
+	while (data_port && !((data_masks[0] >> data_shift) & 1)) {
+		data_shift++;
+	}
+	strobe_port = (BusIO_PortReg *)portOutputRegister(digitalPinToPort(strobe_pin));
+	strobe_mask = digitalPinToBitMask(strobe_pin);
+	dc_port = (BusIO_PortReg *)portOutputRegister(digitalPinToPort(dc_pin));
+	dc_mask = digitalPinToBitMask(dc_pin);
+	if (cs_pin >= 0) {
+		cs_port = (BusIO_PortReg *)portOutputRegister(digitalPinToPort(cs_pin));
+		cs_mask = digitalPinToBitMask(cs_pin);
+	}
+#endif
+	current = -1;
+	return true;
+}
+
+/*!
+    @brief  Select or deselect the display with its CS pin.
+    @param  active
+            true to select it
+*/
+void Adafruit_SSD1322_Parallel::select(bool active)
+{
+	if (cs_pin < 0) {
+		return;
+	}
+#if defined(BUSIO_USE_FAST_PINIO) && SSD1322_FAST_PARALLEL
+	if (active) {
+		*cs_port &= ~cs_mask;
+	} else {
+		*cs_port |= cs_mask;
+	}
+#else
+	digitalWrite(cs_pin, active ? LOW : HIGH);
+#endif
+}
+
+/*!
+    @brief  Set the D/C pin.
+    @param  data
+            true for data, false for commands
+*/
+void Adafruit_SSD1322_Parallel::setDataMode(bool data)
+{
+#if defined(BUSIO_USE_FAST_PINIO) && SSD1322_FAST_PARALLEL
+	if (data) {
+		*dc_port |= dc_mask;
+	} else {
+		*dc_port &= ~dc_mask;
+	}
+#else
+	digitalWrite(dc_pin, data ? HIGH : LOW);
+#endif
+	SSD1322_BUS_DELAY(SSD1322_PARALLEL_SETUP_NS);
+}
+
+/*!
+    @brief  Write bytes, one strobe each.
+    @param  data
+            Bytes to write
+    @param  count
+            Number of bytes
+*/
+void Adafruit_SSD1322_Parallel::write(const uint8_t *data, size_t count)
+{
+	while (count--) {
+		put(*data++);
+		strobe();
+	}
+}
+
+/*!
+    @brief  Write the same byte count times. The data lines are set once,
+            and then only the strobe moves.
+    @param  value
+            Byte to write
+    @param  count
+            Number of times to write it
+*/
+void Adafruit_SSD1322_Parallel::fill(uint8_t value, size_t count)
+{
+	put(value);
+	while (count--) {
+		strobe();
+	}
+}
+
+// Put a byte on D0-D7, only changing the lines that need it.
+void Adafruit_SSD1322_Parallel::put(uint8_t value)
+{
+	if (current == value) {
+		return;
+	}
+	uint8_t changed = (current < 0) ? 0xFF : (value ^ current);
+	current = value;
+
+#if defined(BUSIO_USE_FAST_PINIO) && SSD1322_FAST_PARALLEL
+	if (data_port) {
+		BusIO_PortMask mask = BusIO_PortMask(0xFF) << data_shift;
+		*data_port = (*data_port & ~mask) | (BusIO_PortMask(value) << data_shift);
+		return;
+	}
+	for (uint8_t i = 0; i < 8; i++) {
+		if (changed & (1 << i)) {
+			if (value & (1 << i)) {
+				*data_ports[i] |= data_masks[i];
+			} else {
+				*data_ports[i] &= ~data_masks[i];
+			}
+		}
+	}
+#else
+	for (uint8_t i = 0; i < 8; i++) {
+		if (changed & (1 << i)) {
+			digitalWrite(data_pins[i], (value & (1 << i)) ? HIGH : LOW);
+		}
+	}
+#endif
+}
+
+// Latch the byte on D0-D7: a low pulse on WR# (8080), or a high pulse on E
+// (6800). The pulse is held for SSD1322_PARALLEL_PULSE_NS, which also
+// covers the data setup time before the latching edge, and the bus then
+// rests for the remainder of the write cycle, which covers the hold time
+// before put() changes D0-D7 again.
+void Adafruit_SSD1322_Parallel::strobe(void)
+{
+#if defined(BUSIO_USE_FAST_PINIO) && SSD1322_FAST_PARALLEL
+	if (mode == SSD1322_BUS_8080) {
+		*strobe_port &= ~strobe_mask;
+		SSD1322_BUS_DELAY(SSD1322_PARALLEL_PULSE_NS);
+		*strobe_port |= strobe_mask;
+	} else {
+		*strobe_port |= strobe_mask;
+		SSD1322_BUS_DELAY(SSD1322_PARALLEL_PULSE_NS);
+		*strobe_port &= ~strobe_mask;
+	}
+#else
+	bool idle = (mode == SSD1322_BUS_8080);
+	digitalWrite(strobe_pin, idle ? LOW : HIGH);
+	SSD1322_BUS_DELAY(SSD1322_PARALLEL_PULSE_NS);
+	digitalWrite(strobe_pin, idle ? HIGH : LOW);
+#endif
+	SSD1322_BUS_DELAY(SSD1322_PARALLEL_CYCLE_NS - SSD1322_PARALLEL_PULSE_NS);
+}
@@ -0,0 +1,82 @@
+/*********************************************************************
+8-bit parallel bus for SSD1322/SH1122 displays, as an alternative to
+SPI. See Adafruit_SSD1322.h for the original license text.
+*********************************************************************/
+
+#ifndef _Adafruit_SSD1322_Parallel_H_
+#define _Adafruit_SSD1322_Parallel_H_
+
+#include "Adafruit_SSD1322.h"
+
+// Bus protocols, selected on the controller with its BS pins
+#define SSD1322_BUS_8080 0 ///< Data latched as WR# rises, RD# held high
+#define SSD1322_BUS_6800 1 ///< Data latched as E falls, R/W# held low
+
+// On boards with direct port access the pins are driven through the port
+// registers, paced by SSD1322_BUS_DELAY() (see Adafruit_SSD1322.h). Define
+// this as 0 to use digitalWrite() instead.
+#ifndef SSD1322_FAST_PARALLEL
+#define SSD1322_FAST_PARALLEL 1
+#endif
+
+// Write timing in nanoseconds: the shortest strobe pulse (the controllers'
+// 60 ns write pulse width) and the shortest write cycle, which leaves D0-D7
+// time to settle before the next pulse and to be held after the last. D/C#
+// gets SSD1322_PARALLEL_SETUP_NS to settle before the next strobe.
+#ifndef SSD1322_PARALLEL_PULSE_NS
+#define SSD1322_PARALLEL_PULSE_NS 60
+#endif
+#ifndef SSD1322_PARALLEL_CYCLE_NS
+#define SSD1322_PARALLEL_CYCLE_NS 300
+#endif
+#ifndef SSD1322_PARALLEL_SETUP_NS
+#define SSD1322_PARALLEL_SETUP_NS 20
+#endif
+
+/*!
+    Drives the display over its 8-bit 8080 or 6800 parallel interface.
+    Bytes are written in one go when D0-D7 are consecutive bits of a single
+    port, and bit by bit otherwise. Pass it to the Adafruit_SSD1322
+    constructor that takes a transport.
+*/
+class Adafruit_SSD1322_Parallel : public Adafruit_SSD1322_Transport {
+public:
+  Adafruit_SSD1322_Parallel(const int8_t data_pins[8], int8_t strobe_pin,
+                            int8_t rw_pin, int8_t dc_pin, int8_t cs_pin,
+                            uint8_t mode = SSD1322_BUS_8080);
+
+  bool begin(void);
+  void select(bool active);
+  void setDataMode(bool data);
+  void write(const uint8_t *data, size_t count);
+  void fill(uint8_t value, size_t count);
+
+private:
+  void put(uint8_t value);
+  void strobe(void);
+
+  int8_t data_pins[8];
+  int8_t strobe_pin;
+  int8_t rw_pin;
+  int8_t dc_pin;
+  int8_t cs_pin;
+  uint8_t mode;
+  // The byte on D0-D7, or -1 if unknown
+  int16_t current = -1;
+
+#if defined(BUSIO_USE_FAST_PINIO) && SSD1322_FAST_PARALLEL
+  BusIO_PortReg *data_ports[8];
+  BusIO_PortMask data_masks[8];
+  // Set when D0-D7 are bits shift to shift + 7 of one port
+  BusIO_PortReg *data_port = NULL;
+  uint8_t data_shift = 0;
+  BusIO_PortReg *strobe_port = NULL;
+  BusIO_PortMask strobe_mask = 0;
+  BusIO_PortReg *dc_port = NULL;
+  BusIO_PortMask dc_mask = 0;
+  BusIO_PortReg *cs_port = NULL;
+  BusIO_PortMask cs_mask = 0;
+#endif
+};
+
+#endif // _Adafruit_SSD1322_Parallel_H_
@@ -0,0 +1,380 @@
+/*********************************************************************
+Retained-mode widgets for SSD1322/SH1122 displays. See
+Adafruit_SSD1322.cpp for the original license text.
+
+Dashboards usually change only a few values per frame. Instead of
+redrawing the whole screen and sending the single window around
+everything, widgets keep their own bounds and state, mark themselves
+dirty only when what they show actually changes, and the scene redraws
+just those widgets. Each redraw becomes one dirty rectangle of exactly
+the widget's bounds, so both drawing time and bus traffic scale with
+the number of widgets that changed.
+*********************************************************************/
+
+#include "Adafruit_SSD1322_Widgets.h"
+#include <stdio.h>
+
+// WIDGET ------------------------------------------------------------------
+
+/*!
+    @brief  Constructor for the widget base class.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  w
+            Width in pixels
+    @param  h
+            Height in pixels
+    @param  color
+            Foreground gray level, 0 to 15
+    @param  bg
+            Background gray level, 0 to 15. The whole rectangle is filled
+            with it before the widget is drawn.
+*/
+Adafruit_SSD1322_Widget::Adafruit_SSD1322_Widget(int16_t x, int16_t y,
+                                                 int16_t w, int16_t h,
+                                                 uint8_t color, uint8_t bg)
+    : x(x), y(y), w(w), h(h), color(color), bg(bg) {}
+
+/*!
+    @brief  Change the widget's colors.
+    @param  color
+            Foreground gray level, 0 to 15
+    @param  bg
+            Background gray level, 0 to 15
+*/
+void Adafruit_SSD1322_Widget::setColor(uint8_t color, uint8_t bg)
+{
+	if ((color != this->color) || (bg != this->bg)) {
+		this->color = color;
+		this->bg = bg;
+		dirty = true;
+	}
+}
+
+/*!
+    @brief  Show or hide the widget. A hidden widget's rectangle is filled
+            with its background color.
+    @param  visible
+            true to show the widget
+*/
+void Adafruit_SSD1322_Widget::setVisible(bool visible)
+{
+	if (visible != this->visible) {
+		this->visible = visible;
+		dirty = true;
+	}
+}
+
+// LABEL -------------------------------------------------------------------
+
+/*!
+    @brief  Constructor for a text label.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  w
+            Width in pixels. Make this wide enough for the longest text,
+            since anything beyond it won't be cleared when the text changes.
+    @param  h
+            Height in pixels
+    @param  size
+            Text magnification, as for setTextSize()
+    @param  color
+            Text gray level, 0 to 15
+    @param  bg
+            Background gray level, 0 to 15
+    @note   Text is drawn with the display's current font (setFont()). The
+            display's cursor, text size and colors are changed by drawing.
+*/
+Adafruit_SSD1322_Label::Adafruit_SSD1322_Label(int16_t x, int16_t y,
+                                               int16_t w, int16_t h,
+                                               uint8_t size, uint8_t color,
+                                               uint8_t bg)
+    : Adafruit_SSD1322_Widget(x, y, w, h, color, bg), size(size) {
+  text[0] = 0;
+}
+
+/*!
+    @brief  Set the label's text. The label is only redrawn if the text is
+            different from before.
+    @param  text
+            Up to SSD1322_LABEL_LENGTH characters; the rest is cut off.
+*/
+void Adafruit_SSD1322_Label::setText(const char *text)
+{
+	if (strncmp(text, this->text, SSD1322_LABEL_LENGTH) != 0) {
+		strncpy(this->text, text, SSD1322_LABEL_LENGTH);
+		this->text[SSD1322_LABEL_LENGTH] = 0;
+		dirty = true;
+	}
+}
+
+/*!
+    @brief  Set the label's text to a number.
+    @param  value
+            The number to show
+*/
+void Adafruit_SSD1322_Label::setNumber(long value)
+{
+	// Room for any 64-bit long, sign included.
+	char str[21];
+	snprintf(str, sizeof(str), "%ld", value);
+	setText(str);
+}
+
+void Adafruit_SSD1322_Label::draw(Adafruit_SSD1322 &display)
+{
+	display.setTextSize(size);
+	display.setTextColor(color);
+	display.setTextWrap(false);
+	// Custom fonts put the cursor on the baseline rather than the top
+	// left, so line the top of the text up with the label instead.
+	int16_t bx, by;
+	uint16_t bw, bh;
+	display.getTextBounds(text, 0, 0, &bx, &by, &bw, &bh);
+	display.drawText(x, y - by, text);
+}
+
+// BAR ---------------------------------------------------------------------
+
+/*!
+    @brief  Constructor for a bar graph.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  w
+            Width in pixels, including the outline
+    @param  h
+            Height in pixels, including the outline
+    @param  min_value
+            Value shown as an empty bar
+    @param  max_value
+            Value shown as a full bar
+    @param  color
+            Outline and bar gray level, 0 to 15
+    @param  bg
+            Background gray level, 0 to 15
+*/
+Adafruit_SSD1322_Bar::Adafruit_SSD1322_Bar(int16_t x, int16_t y, int16_t w,
+                                           int16_t h, int16_t min_value,
+                                           int16_t max_value, uint8_t color,
+                                           uint8_t bg)
+    : Adafruit_SSD1322_Widget(x, y, w, h, color, bg), min_value(min_value),
+      max_value(max_value) {}
+
+/*!
+    @brief  Set the value shown. The bar is only redrawn if the filled part
+            changes by at least a pixel.
+    @param  value
+            New value, clamped to the bar's range
+*/
+void Adafruit_SSD1322_Bar::setValue(int16_t value)
+{
+	value = constrain(value, min_value, max_value);
+	int16_t inside = w - 4;
+	int16_t new_fill = 0;
+	if ((max_value > min_value) && (inside > 0)) {
+		new_fill = int32_t(value - min_value) * inside / (max_value - min_value);
+	}
+	if (new_fill != fill) {
+		fill = new_fill;
+		dirty = true;
+	}
+}
+
+void Adafruit_SSD1322_Bar::draw(Adafruit_SSD1322 &display)
+{
+	display.drawRect(x, y, w, h, color);
+	if (fill > 0) {
+		display.fillRect(x + 2, y + 2, fill, h - 4, color);
+	}
+}
+
+// ICON --------------------------------------------------------------------
+
+/*!
+    @brief  Constructor for an icon.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  w
+            Bitmap width in pixels
+    @param  h
+            Bitmap height in pixels
+    @param  bitmap
+            1bpp bitmap in PROGMEM, rows padded to whole bytes, as for
+            drawBitmap(). NULL shows nothing.
+    @param  color
+            Gray level for set bits, 0 to 15
+    @param  bg
+            Gray level for clear bits, 0 to 15
+*/
+Adafruit_SSD1322_Icon::Adafruit_SSD1322_Icon(int16_t x, int16_t y, int16_t w,
+                                             int16_t h, const uint8_t *bitmap,
+                                             uint8_t color, uint8_t bg)
+    : Adafruit_SSD1322_Widget(x, y, w, h, color, bg), bitmap(bitmap) {}
+
+/*!
+    @brief  Change the bitmap shown, e.g. to switch between states.
+    @param  bitmap
+            1bpp bitmap in PROGMEM of the same size, or NULL for nothing.
+*/
+void Adafruit_SSD1322_Icon::setBitmap(const uint8_t *bitmap)
+{
+	if (bitmap != this->bitmap) {
+		this->bitmap = bitmap;
+		dirty = true;
+	}
+}
+
+void Adafruit_SSD1322_Icon::draw(Adafruit_SSD1322 &display)
+{
+	if (bitmap) {
+		display.drawBitmap(x, y, bitmap, w, h, color);
+	}
+}
+
+// SPARKLINE ---------------------------------------------------------------
+
+/*!
+    @brief  Constructor for a sparkline.
+    @param  x
+            Left edge
+    @param  y
+            Top edge
+    @param  w
+            Width in pixels, which is also the number of samples shown
+    @param  h
+            Height in pixels
+    @param  samples
+            Storage for w samples, which must last as long as the widget
+    @param  min_value
+            Value drawn at the bottom edge
+    @param  max_value
+            Value drawn at the top edge
+    @param  color
+            Line gray level, 0 to 15
+    @param  bg
+            Background gray level, 0 to 15
+*/
+Adafruit_SSD1322_Sparkline::Adafruit_SSD1322_Sparkline(
+    int16_t x, int16_t y, int16_t w, int16_t h, uint8_t *samples,
+    int16_t min_value, int16_t max_value, uint8_t color, uint8_t bg)
+    : Adafruit_SSD1322_Widget(x, y, w, h, color, bg), samples(samples),
+      min_value(min_value), max_value(max_value) {}
+
+/*!
+    @brief  Add a value at the right hand end, scrolling the line left once
+            it fills the width.
+    @param  value
+            New value, clamped to the sparkline's range
+*/
+void Adafruit_SSD1322_Sparkline::addValue(int16_t value)
+{
+	value = constrain(value, min_value, max_value);
+	uint8_t height = 0;
+	if (max_value > min_value) {
+		height = int32_t(value - min_value) * (h - 1) / (max_value - min_value);
+	}
+
+	if (count < w) {
+		samples[(head + count) % w] = height;
+		count++;
+	} else {
+		samples[head] = height;
+		head = (head + 1) % w;
+	}
+	dirty = true;
+}
+
+void Adafruit_SSD1322_Sparkline::draw(Adafruit_SSD1322 &display)
+{
+	int16_t bottom = y + h - 1;
+	// Right-align the samples, so new values always appear at the same place.
+	int16_t left = x + w - count;
+	for (int16_t i = 0; i < count; i++) {
+		int16_t py = bottom - samples[(head + i) % w];
+		if (i == 0) {
+			display.drawPixel(left, py, color);
+		} else {
+			int16_t prev = bottom - samples[(head + i - 1) % w];
+			display.drawLine(left + i - 1, prev, left + i, py, color);
+		}
+	}
+}
+
+// SCENE -------------------------------------------------------------------
+
+/*!
+    @brief  Constructor for a scene.
+    @param  display
+            The display the widgets are drawn on.
+*/
+Adafruit_SSD1322_Scene::Adafruit_SSD1322_Scene(Adafruit_SSD1322 &display)
+    : display(display) {}
+
+/*!
+    @brief  Add a widget to the scene. Widgets are drawn in the order they
+            were added, and are not copied, so must outlive the scene.
+    @param  widget
+            The widget to add. It is drawn on the next update().
+*/
+void Adafruit_SSD1322_Scene::add(Adafruit_SSD1322_Widget &widget)
+{
+	widget.next = NULL;
+	widget.dirty = true;
+	if (last) {
+		last->next = &widget;
+	} else {
+		first = &widget;
+	}
+	last = &widget;
+}
+
+/*!
+    @brief  Mark every widget as changed, e.g. after something else has
+            drawn over them.
+*/
+void Adafruit_SSD1322_Scene::invalidateAll(void)
+{
+	for (Adafruit_SSD1322_Widget *widget = first; widget; widget = widget->next) {
+		widget->dirty = true;
+	}
+}
+
+/*!
+    @brief  Redraw the widgets that have changed since the last update, and
+            optionally send them to the display.
+    @param  show
+            If true (the default), call display() afterwards. Pass false to
+            draw other things before calling display() yourself.
+    @return Number of widgets redrawn.
+*/
+uint8_t Adafruit_SSD1322_Scene::update(bool show)
+{
+	uint8_t redrawn = 0;
+	for (Adafruit_SSD1322_Widget *widget = first; widget; widget = widget->next) {
+		if (!widget->dirty) {
+			continue;
+		}
+		// One startWrite()/endWrite() pair around the whole redraw makes it a
+		// single dirty rectangle of the widget's bounds.
+		display.startWrite();
+		display.fillRect(widget->x, widget->y, widget->w, widget->h, widget->bg);
+		if (widget->visible) {
+			widget->draw(display);
+		}
+		display.endWrite();
+		widget->dirty = false;
+		redrawn++;
+	}
+	if (show) {
+		display.display();
+	}
+	return redrawn;
+}
@@ -0,0 +1,140 @@
+/*********************************************************************
+Retained-mode widgets for SSD1322/SH1122 displays. See Adafruit_SSD1322.h
+for the original license text.
+*********************************************************************/
+
+#ifndef _Adafruit_SSD1322_Widgets_H_
+#define _Adafruit_SSD1322_Widgets_H_
+
+#include "Adafruit_SSD1322.h"
+
+// Longest text (not counting the terminating NUL) an
+// Adafruit_SSD1322_Label can hold.
+#ifndef SSD1322_LABEL_LENGTH
+#define SSD1322_LABEL_LENGTH 23
+#endif
+
+/*!
+    Base class for something drawn inside a fixed rectangle of the screen.
+    Each widget remembers whether it has changed since it was last drawn,
+    and the scene it belongs to only redraws the ones that have.
+*/
+class Adafruit_SSD1322_Widget {
+public:
+  Adafruit_SSD1322_Widget(int16_t x, int16_t y, int16_t w, int16_t h,
+                          uint8_t color = 15, uint8_t bg = 0);
+  virtual ~Adafruit_SSD1322_Widget(void) {}
+
+  void setColor(uint8_t color, uint8_t bg);
+  void setVisible(bool visible);
+  void invalidate(void) { dirty = true; }
+  bool isDirty(void) const { return dirty; }
+
+protected:
+  friend class Adafruit_SSD1322_Scene;
+
+  // Draw the widget. The rectangle has already been filled with bg.
+  virtual void draw(Adafruit_SSD1322 &display) = 0;
+
+  int16_t x, y, w, h;
+  uint8_t color, bg;
+  bool visible = true;
+  bool dirty = true;
+
+private:
+  Adafruit_SSD1322_Widget *next = NULL;
+};
+
+/*! A line of text in the display's current font */
+class Adafruit_SSD1322_Label : public Adafruit_SSD1322_Widget {
+public:
+  Adafruit_SSD1322_Label(int16_t x, int16_t y, int16_t w, int16_t h,
+                         uint8_t size = 1, uint8_t color = 15,
+                         uint8_t bg = 0);
+
+  void setText(const char *text);
+  void setNumber(long value);
+
+protected:
+  void draw(Adafruit_SSD1322 &display);
+
+private:
+  char text[SSD1322_LABEL_LENGTH + 1];
+  uint8_t size;
+};
+
+/*! A horizontal bar graph with an outline */
+class Adafruit_SSD1322_Bar : public Adafruit_SSD1322_Widget {
+public:
+  Adafruit_SSD1322_Bar(int16_t x, int16_t y, int16_t w, int16_t h,
+                       int16_t min_value, int16_t max_value,
+                       uint8_t color = 15, uint8_t bg = 0);
+
+  void setValue(int16_t value);
+
+protected:
+  void draw(Adafruit_SSD1322 &display);
+
+private:
+  int16_t min_value, max_value;
+  // Width in pixels of the filled part, which is all that gets drawn.
+  int16_t fill = 0;
+};
+
+/*! A 1bpp bitmap (in PROGMEM), e.g. a status icon */
+class Adafruit_SSD1322_Icon : public Adafruit_SSD1322_Widget {
+public:
+  Adafruit_SSD1322_Icon(int16_t x, int16_t y, int16_t w, int16_t h,
+                        const uint8_t *bitmap, uint8_t color = 15,
+                        uint8_t bg = 0);
+
+  void setBitmap(const uint8_t *bitmap);
+
+protected:
+  void draw(Adafruit_SSD1322 &display);
+
+private:
+  const uint8_t *bitmap;
+};
+
+/*! A scrolling line graph of the most recent values, one per column */
+class Adafruit_SSD1322_Sparkline : public Adafruit_SSD1322_Widget {
+public:
+  Adafruit_SSD1322_Sparkline(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint8_t *samples, int16_t min_value,
+                             int16_t max_value, uint8_t color = 15,
+                             uint8_t bg = 0);
+
+  void addValue(int16_t value);
+
+protected:
+  void draw(Adafruit_SSD1322 &display);
+
+private:
+  // Ring buffer of w samples, stored as heights in pixels above the
+  // bottom edge, with head the index of the oldest.
+  uint8_t *samples;
+  int16_t min_value, max_value;
+  int16_t count = 0;
+  int16_t head = 0;
+};
+
+/*!
+    A set of widgets on one display. update() redraws only the widgets
+    that changed, each as a single dirty rectangle covering its bounds.
+*/
+class Adafruit_SSD1322_Scene {
+public:
+  Adafruit_SSD1322_Scene(Adafruit_SSD1322 &display);
+
+  void add(Adafruit_SSD1322_Widget &widget);
+  void invalidateAll(void);
+  uint8_t update(bool show = true);
+
+private:
+  Adafruit_SSD1322 &display;
+  Adafruit_SSD1322_Widget *first = NULL;
+  Adafruit_SSD1322_Widget *last = NULL;
+};
+
+#endif // _Adafruit_SSD1322_Widgets_H_
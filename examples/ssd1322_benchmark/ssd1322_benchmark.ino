@@ -0,0 +1,205 @@
+// Timing benchmark for Adafruit_SSD1322::display().
+//
+// Runs a fixed set of drawing scenarios and prints how long the drawing
+// and the flush to the panel take for each one, along with the bus
+// traffic for the last frame from the display's update statistics. Use
+// this to check flush changes for both correctness (watch the panel) and
+// speed.
+
+#include <Adafruit_SSD1322.h>
+
+// Used for software SPI
+#define OLED_CLK 13
+#define OLED_MOSI 11
+
+// Used for software or hardware SPI
+#define OLED_CS 10
+#define OLED_DC 8
+
+#define OLED_RESET -1
+
+// Number of frames to run for each scenario
+#define FRAMES 50
+
+// software SPI
+//Adafruit_SSD1322 display(OLED_MOSI, OLED_CLK, OLED_DC, OLED_RESET, OLED_CS);
+// hardware SPI
+Adafruit_SSD1322 display(&SPI, OLED_DC, OLED_RESET, OLED_CS);
+// hardware SPI, SH1122 controller
+//Adafruit_SSD1322 display(&SPI, OLED_DC, OLED_RESET, OLED_CS, Adafruit_SSD1322::VARIANT_SSH1122);
+
+static const unsigned char PROGMEM sprite_bmp[] =
+{ B00000000, B11000000,
+  B00000001, B11000000,
+  B00000001, B11000000,
+  B00000011, B11100000,
+  B11110011, B11100000,
+  B11111110, B11111000,
+  B01111110, B11111111,
+  B00110011, B10011111,
+  B00011111, B11111100,
+  B00001101, B01110000,
+  B00011011, B10100000,
+  B00111111, B11100000,
+  B00111111, B11110000,
+  B01111100, B11110000,
+  B01110000, B01110000,
+  B00000000, B00110000 };
+
+uint32_t draw_us;
+uint32_t display_us;
+
+void flush() {
+  uint32_t start = micros();
+  display.display();
+  display_us += micros() - start;
+}
+
+void report(const char *name) {
+  Serial.print(name);
+  Serial.print(": draw ");
+  Serial.print(draw_us / FRAMES);
+  Serial.print(" us/frame, display ");
+  Serial.print(display_us / FRAMES);
+  Serial.println(" us/frame");
+
+  const Adafruit_SSD1322::Stats *stats = display.getStats();
+  if (stats) {
+    Serial.print("  last frame: ");
+    Serial.print(stats->bytes);
+    Serial.print(" bytes, ");
+    Serial.print(stats->windows);
+    Serial.print(" windows, ");
+    Serial.print(stats->commands);
+    Serial.print(" commands, ");
+    Serial.print(stats->dc_toggles);
+    Serial.print(" DC toggles; ");
+    Serial.print(stats->fps);
+    Serial.println(" fps");
+    Serial.print("  frame times (<1, 2, 4 ... ms):");
+    for (int i = 0; i < SSD1322_STATS_BUCKETS; i++) {
+      Serial.print(' ');
+      Serial.print(stats->histogram[i]);
+    }
+    Serial.println();
+    // Start the next scenario's counts from scratch.
+    display.enableStats();
+  }
+  draw_us = 0;
+  display_us = 0;
+}
+
+// Every pixel changes every frame.
+void benchFullFrame() {
+  for (int f = 0; f < FRAMES; f++) {
+    uint32_t start = micros();
+    display.fillRect(0, 0, display.width(), display.height(), f & 0x0F);
+    draw_us += micros() - start;
+    flush();
+  }
+  report("full frame");
+}
+
+// A log view that scrolls one text line per frame.
+void benchScrollingText() {
+  display.clearDisplay();
+  display.setTextSize(1);
+  display.setTextWrap(false);
+  display.setTextColor(SSD1322_WHITE, SSD1322_BLACK);
+  for (int f = 0; f < FRAMES; f++) {
+    uint32_t start = micros();
+    for (int line = 0; line < 8; line++) {
+      display.setCursor(0, line * 8);
+      display.print("line ");
+      display.print(f + line);
+      display.print(": the quick brown fox");
+    }
+    draw_us += micros() - start;
+    flush();
+  }
+  report("scrolling text");
+}
+
+// A 16x16 sprite moving across an otherwise static screen.
+void benchSprite() {
+  display.clearDisplay();
+  flush();
+  display_us = 0;
+  for (int f = 0; f < FRAMES; f++) {
+    int16_t x = (f * 5) % (display.width() - 16);
+    int16_t y = (f * 3) % (display.height() - 16);
+    uint32_t start = micros();
+    display.fillRect(x, y, 16, 16, SSD1322_BLACK);
+    display.drawBitmap(x, y, sprite_bmp, 16, 16, SSD1322_WHITE);
+    draw_us += micros() - start;
+    flush();
+  }
+  report("small sprite");
+}
+
+// A handful of single pixels spread across the screen.
+void benchScatteredPixels() {
+  display.clearDisplay();
+  flush();
+  display_us = 0;
+  randomSeed(1322);
+  for (int f = 0; f < FRAMES; f++) {
+    uint32_t start = micros();
+    for (int i = 0; i < 8; i++) {
+      display.drawPixel(random(display.width()), random(display.height()),
+                        random(16));
+    }
+    draw_us += micros() - start;
+    flush();
+  }
+  report("scattered pixels");
+}
+
+// Drawing speed of the byte-wide fill primitives against the generic
+// per-pixel versions from Adafruit_GFX. Nothing is sent to the panel.
+void benchFills() {
+  uint32_t start = micros();
+  for (int f = 0; f < FRAMES; f++) {
+    display.fillRect(f, 3, 201, 41, f & 0x0F);
+    display.drawFastHLine(0, f, display.width(), 0x0F - (f & 0x0F));
+  }
+  uint32_t fast_us = micros() - start;
+
+  start = micros();
+  for (int f = 0; f < FRAMES; f++) {
+    display.Adafruit_GFX::fillRect(f, 3, 201, 41, f & 0x0F);
+    display.Adafruit_GFX::drawFastHLine(0, f, display.width(), 0x0F - (f & 0x0F));
+  }
+  uint32_t base_us = micros() - start;
+
+  Serial.print("fills: ");
+  Serial.print(fast_us / FRAMES);
+  Serial.print(" us/frame, Adafruit_GFX ");
+  Serial.print(base_us / FRAMES);
+  Serial.println(" us/frame");
+  display.clearDisplay();
+  flush();
+  display_us = 0;
+}
+
+void setup() {
+  Serial.begin(115200);
+  Serial.println("SSD1322 display() benchmark");
+
+  if (!display.begin()) {
+    Serial.println("Unable to initialize OLED");
+    while (1) yield();
+  }
+  display.clearDisplay();
+  display.display();
+  display.enableStats();
+
+  benchFullFrame();
+  benchScrollingText();
+  benchSprite();
+  benchScatteredPixels();
+  benchFills();
+}
+
+void loop() {
+}
@@ -0,0 +1,69 @@
+// Dashboard built from retained-mode widgets.
+//
+// Twenty readings are shown, but only one of them changes each time around
+// loop(), so only that label is redrawn and sent to the panel.
+
+#include <Adafruit_SSD1322_Widgets.h>
+
+// Used for software SPI
+#define OLED_CLK 13
+#define OLED_MOSI 11
+
+// Used for software or hardware SPI
+#define OLED_CS 10
+#define OLED_DC 8
+
+#define OLED_RESET -1
+
+// software SPI
+//Adafruit_SSD1322 display(OLED_MOSI, OLED_CLK, OLED_DC, OLED_RESET, OLED_CS);
+// hardware SPI
+Adafruit_SSD1322 display(&SPI, OLED_DC, OLED_RESET, OLED_CS);
+
+Adafruit_SSD1322_Scene scene(display);
+
+// Four rows of five readings
+#define READING(i) Adafruit_SSD1322_Label(((i) % 5) * 40, ((i) / 5) * 12, 36, 8)
+Adafruit_SSD1322_Label readings[20] = {
+  READING(0), READING(1), READING(2), READING(3), READING(4),
+  READING(5), READING(6), READING(7), READING(8), READING(9),
+  READING(10), READING(11), READING(12), READING(13), READING(14),
+  READING(15), READING(16), READING(17), READING(18), READING(19)
+};
+
+Adafruit_SSD1322_Bar level(0, 52, 196, 12, 0, 1023);
+
+uint8_t history[56];
+Adafruit_SSD1322_Sparkline trend(200, 0, 56, 64, history, 0, 1023, 10);
+
+void setup() {
+  Serial.begin(115200);
+
+  if (!display.begin()) {
+    Serial.println("Unable to initialize OLED");
+    while (1) yield();
+  }
+  display.clearDisplay();
+
+  for (int i = 0; i < 20; i++) {
+    readings[i].setNumber(0);
+    scene.add(readings[i]);
+  }
+  scene.add(level);
+  scene.add(trend);
+  scene.update();
+}
+
+void loop() {
+  static uint8_t next = 0;
+  int value = analogRead(A0);
+
+  // Only widgets whose contents actually change get redrawn.
+  readings[next].setNumber(value);
+  next = (next + 1) % 20;
+  level.setValue(value);
+  trend.addValue(value);
+
+  scene.update();
+  delay(50);
+}
@@ -0,0 +1,87 @@
+// What display() puts on the bus for the scenarios of
+// examples/ssd1322_benchmark: bytes, commands, DC changes and the time on
+// the wire at 10 MHz, for each controller with and without the shadow
+// buffer. Every frame is checked against the panel as it goes.
+
+#include "harness.h"
+
+#define FRAMES 50
+#define BITRATE 10000000UL
+
+static const uint8_t sprite_bmp[] = {
+    0x00, 0xC0, 0x01, 0xC0, 0x01, 0xC0, 0x03, 0xE0, 0xF3, 0xE0, 0xFE, 0xF8,
+    0x7E, 0xFF, 0x33, 0x9F, 0x1F, 0xFC, 0x0D, 0x70, 0x1B, 0xA0, 0x3F, 0xE0,
+    0x3F, 0xF0, 0x7C, 0xF0, 0x70, 0x70, 0x00, 0x30};
+
+// Every pixel changes every frame.
+static void full_frame(Adafruit_SSD1322 &display, int frame) {
+  display.fillRect(0, 0, display.width(), display.height(), frame & 0x0F);
+}
+
+// A log view that scrolls one text line per frame.
+static void scrolling_text(Adafruit_SSD1322 &display, int frame) {
+  display.setTextWrap(false);
+  display.setTextColor(15, 0);
+  char line[40];
+  for (int row = 0; row < 8; row++) {
+    display.setCursor(0, row * 8);
+    snprintf(line, sizeof(line), "line %d: the quick brown fox", frame + row);
+    display.print(line);
+  }
+}
+
+// A 16x16 sprite moving across an otherwise static screen.
+static void sprite(Adafruit_SSD1322 &display, int frame) {
+  int16_t x = (frame * 5) % (display.width() - 16);
+  int16_t y = (frame * 3) % (display.height() - 16);
+  display.fillRect(x, y, 16, 16, 0);
+  display.drawBitmap(x, y, sprite_bmp, 16, 16, 15);
+}
+
+// A handful of single pixels spread across the screen.
+static void scattered_pixels(Adafruit_SSD1322 &display, int) {
+  for (int i = 0; i < 8; i++) {
+    display.drawPixel(rand() % display.width(), rand() % display.height(),
+                      rand() % 16);
+  }
+}
+
+struct Scenario {
+  const char *name;
+  void (*draw)(Adafruit_SSD1322 &display, int frame);
+};
+
+static const Scenario scenarios[] = {{"full frame", full_frame},
+                                     {"scrolling text", scrolling_text},
+                                     {"small sprite", sprite},
+                                     {"scattered pixels", scattered_pixels}};
+
+int main() {
+  printf("%-8s %-7s %-17s %9s %9s %9s %10s\n", "", "shadow", "scenario",
+         "bytes", "commands", "DC", "wire us");
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    for (int shadow = 0; shadow < 2; shadow++) {
+      for (const Scenario &scenario : scenarios) {
+        Emulator emu(sh1122, TEST_DC, TEST_CS);
+        Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+        EXPECT(display.begin(), "begin() failed");
+        if (shadow) {
+          display.enableShadowBuffer();
+        }
+        display.display();
+        srand(1322);
+        emu.resetCounts();
+        for (int frame = 0; frame < FRAMES; frame++) {
+          scenario.draw(display, frame);
+          display.display();
+          expect_panel(emu, display.getBuffer(), scenario.name);
+        }
+        printf("%-8s %-7s %-17s %9ld %9ld %9ld %10.0f\n", controller(sh1122),
+               shadow ? "yes" : "no", scenario.name, emu.bytes / FRAMES,
+               emu.commands / FRAMES, emu.dc_toggles / FRAMES,
+               emu.wireMicros(BITRATE) / FRAMES);
+      }
+    }
+  }
+  printf("(per frame, averaged over %d frames)\n", FRAMES);
+}
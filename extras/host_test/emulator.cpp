@@ -0,0 +1,277 @@
+#include "emulator.h"
+
+#include <stdio.h>
+
+Emulator::Emulator(bool sh1122, int8_t dc_pin, int8_t cs_pin)
+    : sh1122(sh1122), on(false), start_line(0), display_offset(0),
+      multiplex(63), partial(false), partial_start(0), partial_end(127),
+      dc_pin(dc_pin), cs_pin(cs_pin) {
+  // Display RAM powers up with whatever is in it.
+  memset(ram, 0xAA, sizeof(ram));
+  memset(data_pins, -1, sizeof(data_pins));
+  resetCounts();
+  host_listen(this);
+}
+
+Emulator::~Emulator() { host_unlisten(this); }
+
+void Emulator::connectSoftSPI(int8_t mosi, int8_t sclk) {
+  mosi_pin = mosi;
+  sclk_pin = sclk;
+  soft = true;
+}
+
+void Emulator::connectParallel(const int8_t pins[8], int8_t strobe, int8_t rw,
+                               uint8_t bus_mode) {
+  memcpy(data_pins, pins, sizeof(data_pins));
+  strobe_pin = strobe;
+  rw_pin = rw;
+  mode = bus_mode;
+  parallel = true;
+}
+
+void Emulator::resetCounts(void) {
+  bytes = commands = dc_toggles = selects = errors = 0;
+  log.clear();
+}
+
+double Emulator::wireMicros(uint32_t bitrate, uint32_t dc_ns) const {
+  return bytes * 8e6 / bitrate + dc_toggles * dc_ns / 1000.0;
+}
+
+bool Emulator::selected(void) const {
+  return (cs_pin < 0) || !host_pin(cs_pin);
+}
+
+void Emulator::pinChanged(int pin, int level) {
+  if (pin == dc_pin) {
+    dc_toggles++;
+  }
+  if (pin == cs_pin) {
+    if (!level) {
+      selects++;
+    } else if (bits) {
+      // Deselected in the middle of a byte
+      errors++;
+      bits = 0;
+    }
+  }
+  if (!selected()) {
+    return;
+  }
+  uint64_t now = host_nanos();
+  if (soft && (pin == mosi_pin)) {
+    mosi_changed = now;
+  }
+  if (soft && (pin == sclk_pin) && !level) {
+    // Clock high time
+    if (now - sclk_rose < 50) {
+      errors++;
+    }
+    sclk_fell = now;
+  }
+  if (soft && (pin == sclk_pin) && level) {
+    // Clock low time, and data setup before the rising edge
+    if ((now - sclk_fell < 50) || (now - mosi_changed < 15)) {
+      errors++;
+    }
+    sclk_rose = now;
+    shift = (shift << 1) | host_pin(mosi_pin);
+    if (++bits == 8) {
+      bits = 0;
+      receive(shift);
+    }
+  }
+  if (parallel && (pin != strobe_pin)) {
+    for (int i = 0; i < 8; i++) {
+      if (pin == data_pins[i]) {
+        // Data hold after the latching edge
+        if (strobe_latched && (now - strobe_latched < 7)) {
+          errors++;
+        }
+        data_changed = now;
+      }
+    }
+  }
+  if (parallel && (pin == strobe_pin) && (level != (mode == 0))) {
+    // Start of a write pulse: a cycle since the last one
+    if (strobe_active && (now - strobe_active < 300)) {
+      errors++;
+    }
+    strobe_active = now;
+  }
+  if (parallel && (pin == strobe_pin) && (level == (mode == 0))) {
+    if ((rw_pin >= 0) && (host_pin(rw_pin) != (mode == 0))) {
+      errors++;
+    }
+    // Pulse width, and data setup before the latching edge
+    if ((now - strobe_active < 60) || (now - data_changed < 40)) {
+      errors++;
+    }
+    strobe_latched = now;
+    uint8_t value = 0;
+    for (int i = 0; i < 8; i++) {
+      value |= host_pin(data_pins[i]) << i;
+    }
+    receive(value);
+  }
+}
+
+void Emulator::spiByte(uint8_t value) {
+  if (!soft && !parallel && selected()) {
+    receive(value);
+  }
+}
+
+void Emulator::receive(uint8_t value) {
+  bytes++;
+  log.push_back(value);
+  if (sh1122) {
+    sh1122_byte(value);
+  } else {
+    ssd1322_byte(value);
+  }
+}
+
+// Commands go with D/C# low and their arguments with it high. Data for the
+// RAM window set by 0x15 (columns) and 0x75 (rows) follows 0x5C, two bytes
+// per column, wrapping round the window.
+void Emulator::ssd1322_byte(uint8_t value) {
+  if (!host_pin(dc_pin)) {
+    commands++;
+    command = value;
+    args.clear();
+    writing_ram = (value == 0x5C);
+    if (writing_ram) {
+      col = col1;
+      row = row1;
+      half = 0;
+    } else if (value == 0xAF) {
+      on = true;
+    } else if (value == 0xAE) {
+      on = false;
+    } else if (value == 0xA9) {
+      partial = false;
+    }
+    return;
+  }
+  if (writing_ram) {
+    ram[row & 127][col * 2 + half] = value;
+    if (++half == 2) {
+      half = 0;
+      if (++col > col2) {
+        col = col1;
+        if (++row > row2) {
+          row = row1;
+        }
+      }
+    }
+    return;
+  }
+  args.push_back(value);
+  if ((command == 0x15) && (args.size() == 2)) {
+    col1 = args[0];
+    col2 = args[1];
+  } else if ((command == 0x75) && (args.size() == 2)) {
+    row1 = args[0];
+    row2 = args[1];
+  } else if ((command == 0xA1) && (args.size() == 1)) {
+    start_line = value;
+  } else if ((command == 0xA2) && (args.size() == 1)) {
+    display_offset = value;
+  } else if ((command == 0xA8) && (args.size() == 2)) {
+    partial = true;
+    partial_start = args[0];
+    partial_end = args[1];
+  }
+}
+
+// Everything but RAM data goes with D/C# low, arguments included. The RAM
+// address is a row set by 0xB0 and a column set in two halves; writes move
+// along the row and on to the next one.
+void Emulator::sh1122_byte(uint8_t value) {
+  if (host_pin(dc_pin)) {
+    ram[row & 63][col] = value;
+    if (++col >= 128) {
+      col = 0;
+      row = (row + 1) & 63;
+    }
+    return;
+  }
+  if (pending) {
+    if (pending == 0xB0) {
+      row = value;
+    } else if (pending == 0xD3) {
+      display_offset = value;
+    } else if (pending == 0xA8) {
+      multiplex = value;
+    }
+    pending = 0;
+    return;
+  }
+  commands++;
+  switch (value) {
+  case 0x81: // Contrast
+  case 0xA8: // Multiplex ratio
+  case 0xAD: // DC-DC control
+  case 0xB0: // Row address
+  case 0xD3: // Display offset
+  case 0xD5: // Clock
+  case 0xD9: // Precharge
+  case 0xDB: // VCOM deselect level
+  case 0xDC: // VSEG level
+    pending = value;
+    return;
+  case 0xAE:
+    on = false;
+    return;
+  case 0xAF:
+    on = true;
+    return;
+  }
+  if (value <= 0x0F) {
+    col = (col & 0x70) | value;
+  } else if (value <= 0x17) {
+    col = (col & 0x0F) | ((value & 0x07) << 4);
+  } else if ((value >= 0x40) && (value <= 0x7F)) {
+    start_line = value & 0x3F;
+  }
+}
+
+// The display offset moves the picture up. The SH1122 scans multiplex + 1
+// rows from the start line, placed on the panel by the display offset, and
+// leaves the rest dark. The SSD1322's partial display mode leaves every
+// row outside its range of RAM rows dark.
+uint8_t Emulator::visible(int y, int xb, int width) const {
+  if (sh1122) {
+    int scan = (y + display_offset) & 63;
+    if (scan > multiplex) {
+      return 0;
+    }
+    return ram[(scan + start_line) & 63][xb];
+  }
+  int row = (y + display_offset + start_line) & 127;
+  if (partial && ((row < partial_start) || (row > partial_end))) {
+    return 0;
+  }
+  int first_col = (480 - width) / 8;
+  return ram[row][first_col * 2 + xb];
+}
+
+int Emulator::compare(const uint8_t *buffer, int width, int h, int y0) const {
+  int bad = 0;
+  for (int y = 0; y < h; y++) {
+    for (int xb = 0; xb < width / 2; xb++) {
+      uint8_t shown = visible(y0 + y, xb, width);
+      uint8_t want = buffer[y * (width / 2) + xb];
+      if (shown != want) {
+        if (bad < 5) {
+          printf("row %d byte %d: panel %02x, buffer %02x\n", y0 + y, xb, shown,
+                 want);
+        }
+        bad++;
+      }
+    }
+  }
+  return bad;
+}
@@ -0,0 +1,100 @@
+// An SSD1322 or SH1122 controller on the simulated bus. It decodes what the
+// library sends, whether over hardware SPI, bitbanged SPI or the 8-bit
+// parallel bus, into display RAM, and counts the traffic.
+
+#ifndef HOST_EMULATOR_H
+#define HOST_EMULATOR_H
+
+#include <Arduino.h>
+#include <host.h>
+
+#include <vector>
+
+class Emulator : public HostListener {
+public:
+  // A controller whose D/C# and CS# pins are wired to dc_pin and cs_pin
+  // (-1 if CS# is tied low), taking bytes from hardware SPI.
+  Emulator(bool sh1122, int8_t dc_pin, int8_t cs_pin);
+  ~Emulator();
+
+  // Clock bits in from these pins instead (SPI mode 0, MSB first). The
+  // clock is checked against the controllers' serial timing: 50 ns high
+  // and low, with 15 ns of data setup.
+  void connectSoftSPI(int8_t mosi_pin, int8_t sclk_pin);
+  // Latch bytes from D0-D7 instead, with the protocol's strobe: WR# rising
+  // for 8080 (mode 0), E falling for 6800 (mode 1). rw_pin is RD# or
+  // R/W#, which must stay at the write level, or -1 if not wired. Writes
+  // are checked against the write timing both controllers share: 60 ns
+  // pulses, 300 ns cycles, 40 ns data setup and 7 ns data hold.
+  void connectParallel(const int8_t data_pins[8], int8_t strobe_pin,
+                       int8_t rw_pin, uint8_t mode);
+
+  // Bus traffic since the last resetCounts().
+  long bytes;      // Everything, commands and arguments included
+  long commands;   // Command bytes, not counting their arguments
+  long dc_toggles; // Changes of the D/C# pin
+  long selects;    // Times CS# was asserted
+  long errors;     // Protocol violations: partial bytes, wrong R/W# level,
+                   // bus edges faster than the controller's timing
+  std::vector<uint8_t> log; // Every byte received
+  void resetCounts(void);
+
+  // Time the traffic since resetCounts() would take on a bus running at
+  // bitrate bits per second, with dc_ns added for each D/C# change.
+  double wireMicros(uint32_t bitrate, uint32_t dc_ns = 0) const;
+
+  // Controller state
+  bool sh1122;
+  bool on;
+  uint8_t start_line;
+  uint8_t display_offset;
+  uint8_t multiplex; // SH1122: rows scanned, less one
+  bool partial;      // SSD1322: partial display mode, showing RAM rows
+  uint8_t partial_start, partial_end; // partial_start to partial_end
+  // SSD1322: 120 columns of 4 pixels (2 bytes) by 128 rows.
+  // SH1122: 128 bytes (256 pixels) by 64 rows.
+  uint8_t ram[128][256];
+
+  // Byte xb of visible row y (start line, display offset, multiplex ratio
+  // and partial display applied) on a panel width pixels wide. The
+  // SSD1322's panel sits in the middle of its 480 columns.
+  uint8_t visible(int y, int xb, int width) const;
+
+  // Compare rows y0 to y0 + h - 1 of what the panel shows with a frame
+  // buffer h rows high, printing the first few differences. Returns the
+  // number of bytes that differ.
+  int compare(const uint8_t *buffer, int width, int h, int y0 = 0) const;
+
+  void pinChanged(int pin, int level);
+  void spiByte(uint8_t value);
+
+private:
+  bool selected(void) const;
+  void receive(uint8_t value);
+  void ssd1322_byte(uint8_t value);
+  void sh1122_byte(uint8_t value);
+
+  int8_t dc_pin, cs_pin;
+  int8_t mosi_pin = -1, sclk_pin = -1;
+  int8_t data_pins[8];
+  int8_t strobe_pin = -1, rw_pin = -1;
+  uint8_t mode = 0;
+  bool soft = false, parallel = false;
+
+  // Bus edges, in simulated ns, for the timing checks
+  uint64_t data_changed = 0, strobe_active = 0, strobe_latched = 0;
+  uint64_t mosi_changed = 0, sclk_rose = 0, sclk_fell = 0;
+
+  // Bits clocked in so far in soft SPI mode
+  uint8_t shift = 0, bits = 0;
+
+  // Command decoding
+  uint8_t command = 0;
+  bool writing_ram = false;
+  std::vector<uint8_t> args;
+  uint8_t pending = 0; // SH1122 command waiting for its argument byte
+  int col1 = 0, col2 = 119, row1 = 0, row2 = 127;
+  int col = 0, row = 0, half = 0;
+};
+
+#endif // HOST_EMULATOR_H
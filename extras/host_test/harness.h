@@ -0,0 +1,98 @@
+// Shared pieces of the host tests.
+
+#ifndef HOST_HARNESS_H
+#define HOST_HARNESS_H
+
+#include "emulator.h"
+
+#include <Adafruit_SSD1322.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+// Pins used by the tests' displays
+#define TEST_DC 8
+#define TEST_CS 10
+#define TEST_MOSI 11
+#define TEST_SCLK 13
+
+// Report a failure and end the test.
+inline void fail(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  printf("FAIL: ");
+  vprintf(format, args);
+  printf("\n");
+  va_end(args);
+  exit(1);
+}
+
+#define EXPECT(condition, ...)                                                 \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fail(__VA_ARGS__);                                                       \
+    }                                                                          \
+  } while (0)
+
+inline int8_t variant(bool sh1122) {
+  return sh1122 ? Adafruit_SSD1322::VARIANT_SSH1122
+                : Adafruit_SSD1322::VARIANT_SSD1322;
+}
+
+inline const char *controller(bool sh1122) {
+  return sh1122 ? "SH1122" : "SSD1322";
+}
+
+// Check that a 256x64 panel shows the whole of a frame buffer.
+inline void expect_panel(const Emulator &emu, const uint8_t *buffer,
+                         const char *what) {
+  EXPECT(!emu.compare(buffer, 256, 64), "%s: panel differs from the frame buffer",
+         what);
+}
+
+// Adafruit_GrayOLED's own per-pixel drawing, as the reference for the
+// display's fast paths.
+class Reference : public Adafruit_GrayOLED {
+public:
+  Reference(uint16_t w = 256, uint16_t h = 64)
+      : Adafruit_GrayOLED(4, w, h, (TwoWire *)NULL) {
+    buffer = (uint8_t *)malloc(w / 2 * h);
+    clearDisplay();
+  }
+  void display(void) {}
+};
+
+inline uint8_t nibble(const uint8_t *buffer, int stride, int x, int y) {
+  uint8_t b = buffer[y * stride + x / 2];
+  return (x & 1) ? (b & 0x0F) : (b >> 4);
+}
+
+// A font of random glyphs, some empty, with odd offsets and advances.
+struct RandomFont {
+  uint8_t bits[4096];
+  GFXglyph glyphs[96];
+  GFXfont font;
+
+  RandomFont() {
+    for (int i = 0; i < 4096; i++) {
+      bits[i] = rand();
+    }
+    uint16_t offset = 0;
+    for (int i = 0; i < 96; i++) {
+      GFXglyph &g = glyphs[i];
+      g.bitmapOffset = offset;
+      g.width = rand() % 14;
+      g.height = rand() % 16;
+      g.xAdvance = rand() % 16;
+      g.xOffset = rand() % 5 - 2;
+      g.yOffset = -(rand() % 16);
+      offset += (g.width * g.height + 7) / 8;
+    }
+    font.bitmap = bits;
+    font.glyph = glyphs;
+    font.first = 32;
+    font.last = 127;
+    font.yAdvance = 17;
+  }
+};
+
+#endif // HOST_HARNESS_H
@@ -0,0 +1,267 @@
+// A cut-down Adafruit GFX with the same pixel-by-pixel drawing as the real
+// library, which the tests use as the reference for the display's fast
+// paths. The built-in 5x7 font is replaced by a fixed pattern per
+// character: only its placement matters here.
+
+#ifndef HOST_ADAFRUIT_GFX_H
+#define HOST_ADAFRUIT_GFX_H
+
+#include "Arduino.h"
+#include "gfxfont.h"
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h)
+      : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+        textcolor(0xFFFF), textbgcolor(0xFFFF), textsize_x(1), textsize_y(1),
+        rotation(0), wrap(true), gfxFont(NULL) {}
+  virtual ~Adafruit_GFX() {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  virtual void startWrite(void) {}
+  virtual void writePixel(int16_t x, int16_t y, uint16_t color) {
+    drawPixel(x, y, color);
+  }
+  virtual void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                             uint16_t color) {
+    fillRect(x, y, w, h, color);
+  }
+  virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    drawFastVLine(x, y, h, color);
+  }
+  virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+  }
+  virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                         uint16_t color) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+      std::swap(x0, y0);
+      std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+      std::swap(x0, x1);
+      std::swap(y0, y1);
+    }
+    int16_t dx = x1 - x0, dy = abs(y1 - y0);
+    int16_t err = dx / 2, ystep = (y0 < y1) ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+      if (steep) {
+        writePixel(y0, x0, color);
+      } else {
+        writePixel(x0, y0, color);
+      }
+      err -= dy;
+      if (err < 0) {
+        y0 += ystep;
+        err += dx;
+      }
+    }
+  }
+  virtual void endWrite(void) {}
+
+  virtual void setRotation(uint8_t r) {
+    rotation = r & 3;
+    _width = (rotation & 1) ? HEIGHT : WIDTH;
+    _height = (rotation & 1) ? WIDTH : HEIGHT;
+  }
+  virtual void invertDisplay(bool) {}
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    startWrite();
+    writeLine(x, y, x, y + h - 1, color);
+    endWrite();
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    startWrite();
+    writeLine(x, y, x + w - 1, y, color);
+    endWrite();
+  }
+  virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color) {
+    startWrite();
+    for (int16_t i = x; i < x + w; i++) {
+      writeFastVLine(i, y, h, color);
+    }
+    endWrite();
+  }
+  virtual void fillScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+  }
+  virtual void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                        uint16_t color) {
+    startWrite();
+    writeLine(x0, y0, x1, y1, color);
+    endWrite();
+  }
+  virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                        uint16_t color) {
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color);
+    writeFastVLine(x + w - 1, y, h, color);
+    endWrite();
+  }
+
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                  int16_t h, uint16_t color) {
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t b = 0;
+    startWrite();
+    for (int16_t j = 0; j < h; j++, y++) {
+      for (int16_t i = 0; i < w; i++) {
+        b = (i & 7) ? b << 1 : pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+        if (b & 0x80) {
+          writePixel(x + i, y, color);
+        }
+      }
+    }
+    endWrite();
+  }
+  void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w,
+                  int16_t h, uint16_t color, uint16_t bg) {
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t b = 0;
+    startWrite();
+    for (int16_t j = 0; j < h; j++, y++) {
+      for (int16_t i = 0; i < w; i++) {
+        b = (i & 7) ? b << 1 : pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+        writePixel(x + i, y, (b & 0x80) ? color : bg);
+      }
+    }
+    endWrite();
+  }
+  void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h,
+                  uint16_t color) {
+    drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color);
+  }
+  void drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h,
+                  uint16_t color, uint16_t bg) {
+    drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color, bg);
+  }
+
+  void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1,
+                     int16_t *y1, uint16_t *w, uint16_t *h) {
+    *x1 = x;
+    *y1 = y;
+    *w = 0;
+    *h = 0;
+    if (!gfxFont) {
+      *w = strlen(str) * 6 * textsize_x;
+      *h = 8 * textsize_y;
+      return;
+    }
+    int16_t miny = 0x7FFF;
+    for (const char *p = str; *p; p++) {
+      uint8_t c = *p;
+      if ((c < gfxFont->first) || (c > gfxFont->last)) {
+        continue;
+      }
+      GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+      if (glyph->height && (glyph->yOffset * textsize_y < miny)) {
+        miny = glyph->yOffset * textsize_y;
+      }
+    }
+    if (miny != 0x7FFF) {
+      *y1 = y + miny;
+    }
+  }
+
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                uint16_t bg, uint8_t, uint8_t) {
+    startWrite();
+    if (!gfxFont) {
+      for (int i = 0; i < 5; i++) {
+        for (int j = 0; j < 8; j++) {
+          if ((c >> ((i + j) & 7)) & 1) {
+            writePixel(x + i, y + j, color);
+          } else if (bg != color) {
+            writePixel(x + i, y + j, bg);
+          }
+        }
+      }
+      endWrite();
+      return;
+    }
+    GFXglyph *glyph = gfxFont->glyph + (uint8_t)(c - gfxFont->first);
+    const uint8_t *bitmap = gfxFont->bitmap + glyph->bitmapOffset;
+    uint8_t bits = 0, bit = 0;
+    for (uint8_t yy = 0; yy < glyph->height; yy++) {
+      for (uint8_t xx = 0; xx < glyph->width; xx++) {
+        if (!(bit++ & 7)) {
+          bits = *bitmap++;
+        }
+        if (bits & 0x80) {
+          writePixel(x + glyph->xOffset + xx, y + glyph->yOffset + yy, color);
+        }
+        bits <<= 1;
+      }
+    }
+    endWrite();
+  }
+
+  virtual size_t write(uint8_t c) {
+    if (!gfxFont) {
+      if (c == '\n') {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+      } else if (c != '\r') {
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+                 textsize_y);
+        cursor_x += textsize_x * 6;
+      }
+      return 1;
+    }
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+    } else if ((c != '\r') && (c >= gfxFont->first) && (c <= gfxFont->last)) {
+      GFXglyph *glyph = gfxFont->glyph + (c - gfxFont->first);
+      if ((glyph->width > 0) && (glyph->height > 0)) {
+        if (wrap && ((cursor_x + textsize_x * (glyph->xOffset + glyph->width)) >
+                     _width)) {
+          cursor_x = 0;
+          cursor_y += (int16_t)textsize_y * gfxFont->yAdvance;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+                 textsize_y);
+      }
+      cursor_x += glyph->xAdvance * (int16_t)textsize_x;
+    }
+    return 1;
+  }
+
+  void setCursor(int16_t x, int16_t y) {
+    cursor_x = x;
+    cursor_y = y;
+  }
+  void setTextColor(uint16_t c) { textcolor = textbgcolor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) {
+    textcolor = c;
+    textbgcolor = bg;
+  }
+  void setTextSize(uint8_t s) { textsize_x = textsize_y = s; }
+  void setTextWrap(bool w) { wrap = w; }
+  void setFont(const GFXfont *f = NULL) { gfxFont = (GFXfont *)f; }
+
+  int16_t width(void) const { return _width; }
+  int16_t height(void) const { return _height; }
+  uint8_t getRotation(void) const { return rotation; }
+  int16_t getCursorX(void) const { return cursor_x; }
+  int16_t getCursorY(void) const { return cursor_y; }
+
+protected:
+  int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x, cursor_y;
+  uint16_t textcolor, textbgcolor;
+  uint8_t textsize_x, textsize_y;
+  uint8_t rotation;
+  bool wrap;
+  bool _cp437 = false;
+  GFXfont *gfxFont;
+};
+
+#endif // HOST_ADAFRUIT_GFX_H
@@ -0,0 +1,129 @@
+// The parts of Adafruit_GrayOLED the library builds on, for 4 bits per
+// pixel over SPI. drawPixel() is the plain per-pixel version, which the
+// tests use as the reference for the display's own drawing.
+
+#ifndef HOST_ADAFRUIT_GRAYOLED_H
+#define HOST_ADAFRUIT_GRAYOLED_H
+
+#include "Adafruit_GFX.h"
+#include "Adafruit_SPIDevice.h"
+#include "SPI.h"
+#include "Wire.h"
+
+#define GRAYOLED_BLACK 0
+
+class Adafruit_GrayOLED : public Adafruit_GFX {
+public:
+  Adafruit_GrayOLED(uint8_t bpp, uint16_t w, uint16_t h, int8_t mosi_pin,
+                    int8_t sclk_pin, int8_t dc_pin, int8_t rst_pin,
+                    int8_t cs_pin)
+      : Adafruit_GFX(w, h), dcPin(dc_pin), csPin(cs_pin), rstPin(rst_pin),
+        _bpp(bpp) {
+    spi_dev = new Adafruit_SPIDevice(cs_pin, sclk_pin, -1, mosi_pin, 1000000);
+  }
+  Adafruit_GrayOLED(uint8_t bpp, uint16_t w, uint16_t h, SPIClass *spi,
+                    int8_t dc_pin, int8_t rst_pin, int8_t cs_pin,
+                    uint32_t bitrate = 8000000UL)
+      : Adafruit_GFX(w, h), dcPin(dc_pin), csPin(cs_pin), rstPin(rst_pin),
+        _bpp(bpp) {
+    spi_dev = new Adafruit_SPIDevice(cs_pin, bitrate, 0, 0, spi);
+  }
+  Adafruit_GrayOLED(uint8_t bpp, uint16_t w, uint16_t h, TwoWire * = &Wire,
+                    int8_t rst_pin = -1, uint32_t = 400000, uint32_t = 100000)
+      : Adafruit_GFX(w, h), dcPin(-1), csPin(-1), rstPin(rst_pin), _bpp(bpp) {}
+  ~Adafruit_GrayOLED(void) {
+    free(buffer);
+    delete spi_dev;
+  }
+
+  virtual void display(void) = 0;
+
+  void clearDisplay(void) {
+    memset(buffer, 0, _bpp * WIDTH * ((HEIGHT + 7) / 8));
+    window_x1 = 0;
+    window_y1 = 0;
+    window_x2 = WIDTH - 1;
+    window_y2 = HEIGHT - 1;
+  }
+  void invertDisplay(bool) {}
+  void setContrast(uint8_t) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) {
+      return;
+    }
+    rotate(x, y);
+    window_x1 = min(window_x1, x);
+    window_y1 = min(window_y1, y);
+    window_x2 = max(window_x2, x);
+    window_y2 = max(window_y2, y);
+    uint8_t *pixel = &buffer[x / 2 + (y * WIDTH / 2)];
+    if (x % 2 == 0) {
+      *pixel = (*pixel & 0x0F) | ((color & 0x0F) << 4);
+    } else {
+      *pixel = (*pixel & 0xF0) | (color & 0x0F);
+    }
+  }
+  // As in the real library: the whole frame buffer is assumed to be there.
+  bool getPixel(int16_t x, int16_t y) {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) {
+      return false;
+    }
+    rotate(x, y);
+    uint8_t b = buffer[x / 2 + (y * WIDTH / 2)];
+    return (x % 2) ? (b & 0x0F) : (b >> 4);
+  }
+  uint8_t *getBuffer(void) { return buffer; }
+
+  // Sends through spi_dev, which is NULL without SPI.
+  void oled_command(uint8_t c) {
+    digitalWrite(dcPin, LOW);
+    spi_dev->write(&c, 1);
+  }
+
+protected:
+  bool _init(uint8_t = 0x3C, bool reset = true) {
+    if (!buffer && !(buffer = (uint8_t *)malloc(_bpp * WIDTH *
+                                                 ((HEIGHT + 7) / 8)))) {
+      return false;
+    }
+    clearDisplay();
+    if (reset && (rstPin >= 0)) {
+      pinMode(rstPin, OUTPUT);
+      digitalWrite(rstPin, HIGH);
+      delay(10);
+      digitalWrite(rstPin, LOW);
+      delay(10);
+      digitalWrite(rstPin, HIGH);
+      delay(10);
+    }
+    pinMode(dcPin, OUTPUT);
+    return spi_dev->begin();
+  }
+
+  Adafruit_SPIDevice *spi_dev = NULL;
+  uint8_t *buffer = NULL;
+  int16_t window_x1, window_y1, window_x2, window_y2;
+  int dcPin, csPin, rstPin;
+  uint8_t _bpp = 1;
+
+private:
+  void rotate(int16_t &x, int16_t &y) {
+    switch (getRotation()) {
+    case 1:
+      std::swap(x, y);
+      x = WIDTH - x - 1;
+      break;
+    case 2:
+      x = WIDTH - x - 1;
+      y = HEIGHT - y - 1;
+      break;
+    case 3:
+      std::swap(x, y);
+      y = HEIGHT - y - 1;
+      break;
+    }
+  }
+};
+
+#endif // HOST_ADAFRUIT_GRAYOLED_H
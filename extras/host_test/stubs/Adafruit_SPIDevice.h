@@ -0,0 +1,91 @@
+// Adafruit BusIO's SPI device. Hardware SPI hands each byte to the
+// emulated controllers (see host.h) and takes 8 bit times at the
+// configured frequency; software SPI bitbangs the MOSI and SCK pins with
+// digitalWrite(), which the controllers decode themselves.
+
+#ifndef HOST_ADAFRUIT_SPIDEVICE_H
+#define HOST_ADAFRUIT_SPIDEVICE_H
+
+#include "SPI.h"
+#include "host.h"
+
+#ifdef HOST_FAST_PINIO
+#define BUSIO_USE_FAST_PINIO
+typedef HostPort BusIO_PortReg;
+#else
+typedef uint8_t BusIO_PortReg;
+#endif
+typedef uint8_t BusIO_PortMask;
+
+class Adafruit_SPIDevice {
+public:
+  Adafruit_SPIDevice(int8_t cspin, uint32_t freq = 1000000, int = 0,
+                     int = 0, SPIClass * = &SPI)
+      : cs(cspin), sck(-1), mosi(-1), freq(freq) {}
+  Adafruit_SPIDevice(int8_t cspin, int8_t sckpin, int8_t, int8_t mosipin,
+                     uint32_t freq = 1000000, int = 0, int = 0)
+      : cs(cspin), sck(sckpin), mosi(mosipin), freq(freq) {}
+
+  bool begin(void) {
+    if (cs >= 0) {
+      pinMode(cs, OUTPUT);
+      digitalWrite(cs, HIGH);
+    }
+    if (sck >= 0) {
+      pinMode(sck, OUTPUT);
+      digitalWrite(sck, LOW);
+      pinMode(mosi, OUTPUT);
+    }
+    return true;
+  }
+
+  uint8_t transfer(uint8_t value) {
+    if (sck < 0) {
+      host_advance(uint32_t(8000000000ULL / freq));
+      host_spi_byte(value);
+      return 0xFF;
+    }
+    for (uint8_t bit = 0x80; bit; bit >>= 1) {
+      digitalWrite(mosi, (value & bit) ? HIGH : LOW);
+      digitalWrite(sck, HIGH);
+      digitalWrite(sck, LOW);
+    }
+    return 0xFF;
+  }
+  void transfer(uint8_t *buffer, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      buffer[i] = transfer(buffer[i]);
+    }
+  }
+  bool write(const uint8_t *buffer, size_t len,
+             const uint8_t *prefix_buffer = NULL, size_t prefix_len = 0) {
+    beginTransactionWithAssertingCS();
+    for (size_t i = 0; i < prefix_len; i++) {
+      transfer(prefix_buffer[i]);
+    }
+    for (size_t i = 0; i < len; i++) {
+      transfer(buffer[i]);
+    }
+    endTransactionWithDeassertingCS();
+    return true;
+  }
+
+  void beginTransaction(void) {}
+  void endTransaction(void) {}
+  void beginTransactionWithAssertingCS(void) {
+    if (cs >= 0) {
+      digitalWrite(cs, LOW);
+    }
+  }
+  void endTransactionWithDeassertingCS(void) {
+    if (cs >= 0) {
+      digitalWrite(cs, HIGH);
+    }
+  }
+
+private:
+  int8_t cs, sck, mosi;
+  uint32_t freq;
+};
+
+#endif // HOST_ADAFRUIT_SPIDEVICE_H
@@ -0,0 +1,104 @@
+// Just enough of the Arduino core to build the library on a Linux host.
+//
+// Time is simulated: it only moves when something takes time (a pin write,
+// an SPI byte, delay()) or is read with micros()/millis(), so runs are
+// repeatable. Pin levels are tracked so that an emulated controller can
+// watch the DC, CS and bitbanged bus pins (see host.h).
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "binary.h"
+
+#ifdef HOST_SAMD_DMA
+// Pass for Adafruit's SAMD core, for its background SPI transfers
+#define ARDUINO_ARCH_SAMD
+#define ARDUINO_SAMD_ADAFRUIT
+#endif
+
+using std::max;
+using std::min;
+
+typedef bool boolean;
+
+#define LOW 0
+#define HIGH 1
+#define INPUT 0
+#define OUTPUT 1
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define NOT_AN_INTERRUPT -1
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_pointer(addr) (*(void *const *)(addr))
+#define memcpy_P memcpy
+
+#define constrain(amt, low, high)                                              \
+  ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int level);
+int digitalRead(int pin);
+
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+// As on Teensy; the Makefile points SSD1322_BUS_DELAY() at it.
+void delayNanoseconds(unsigned int ns);
+unsigned long millis(void);
+unsigned long micros(void);
+void yield(void);
+
+// Every pin can take an interrupt; host_interrupt() in host.h fires one.
+inline int digitalPinToInterrupt(int pin) { return pin; }
+void attachInterrupt(int interrupt, void (*isr)(void), int mode);
+void detachInterrupt(int interrupt);
+#define noInterrupts()
+#define interrupts()
+
+#ifdef HOST_FAST_PINIO
+// Direct port access, as on AVR and SAMD: pin n is bit n % 8 of port
+// n / 8. Port writes change the same pin levels digitalWrite() does.
+class HostPort {
+public:
+  explicit HostPort(uint8_t index) : index(index) {}
+  operator uint8_t() const;
+  HostPort &operator=(uint8_t value);
+  HostPort &operator|=(uint8_t mask) { return *this = uint8_t(*this | mask); }
+  HostPort &operator&=(uint8_t mask) { return *this = uint8_t(*this & mask); }
+
+private:
+  uint8_t index;
+};
+
+HostPort *portOutputRegister(uint8_t port);
+inline uint8_t digitalPinToPort(int pin) { return pin / 8; }
+inline uint8_t digitalPinToBitMask(int pin) { return 1 << (pin % 8); }
+#endif
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  size_t print(const char *s) {
+    size_t n = 0;
+    while (*s) {
+      n += write(*s++);
+    }
+    return n;
+  }
+  size_t println(const char *s) { return print(s) + write('\n'); }
+};
+
+#endif // HOST_ARDUINO_H
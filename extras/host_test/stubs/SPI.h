@@ -0,0 +1,35 @@
+// The hardware SPI port. Bytes are sent through Adafruit_SPIDevice, so
+// there is nothing in it, except in the dma build: there it has the
+// background transfers of Adafruit's SAMD core. A transfer moves along
+// HOST_DMA_STEP bytes each time isBusy() is asked, so the sketch gets to
+// run while it is on the wire.
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+#ifdef HOST_SAMD_DMA
+#define HOST_DMA_STEP 64
+
+class SPIClass {
+public:
+  void transfer(const void *txbuf, void *rxbuf, size_t count,
+                bool block = true);
+  void waitForTransfer(void);
+  bool isBusy(void);
+
+  // Number of transfers started, for the tests
+  long transfers = 0;
+
+private:
+  const uint8_t *dma_data = NULL;
+  size_t dma_left = 0;
+};
+#else
+class SPIClass {};
+#endif
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
@@ -0,0 +1,12 @@
+// I2C is never used with these displays; the type is only needed by the
+// Adafruit_GrayOLED constructors.
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+class TwoWire {};
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
@@ -0,0 +1,25 @@
+// Font structures, as in Adafruit GFX.
+
+#ifndef HOST_GFXFONT_H
+#define HOST_GFXFONT_H
+
+#include <stdint.h>
+
+typedef struct {
+  uint16_t bitmapOffset; ///< Offset of the glyph's bitmap in the font's bitmap
+  uint8_t width;         ///< Bitmap width in pixels
+  uint8_t height;        ///< Bitmap height in pixels
+  uint8_t xAdvance;      ///< Distance to advance the cursor
+  int8_t xOffset;        ///< Cursor to top left of the bitmap, x
+  int8_t yOffset;        ///< Cursor to top left of the bitmap, y
+} GFXglyph;
+
+typedef struct {
+  uint8_t *bitmap;  ///< All glyph bitmaps, concatenated
+  GFXglyph *glyph;  ///< Glyph array
+  uint16_t first;   ///< First character
+  uint16_t last;    ///< Last character
+  uint8_t yAdvance; ///< Line height
+} GFXfont;
+
+#endif // HOST_GFXFONT_H
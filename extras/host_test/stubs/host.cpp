@@ -0,0 +1,151 @@
+// The host Arduino core: simulated pins, time and interrupts.
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "Wire.h"
+#include "host.h"
+
+#include <vector>
+
+SPIClass SPI;
+TwoWire Wire;
+
+#define HOST_PINS 256
+
+static uint8_t pin_levels[HOST_PINS];
+static void (*interrupt_handlers[HOST_PINS])(void);
+static std::vector<HostListener *> listeners;
+static uint64_t now_ns = 0;
+
+void host_listen(HostListener *listener) { listeners.push_back(listener); }
+
+void host_unlisten(HostListener *listener) {
+  for (size_t i = 0; i < listeners.size(); i++) {
+    if (listeners[i] == listener) {
+      listeners.erase(listeners.begin() + i);
+      return;
+    }
+  }
+}
+
+void host_set_pin(int pin, int level) {
+  if ((pin < 0) || (pin >= HOST_PINS) || (pin_levels[pin] == level)) {
+    return;
+  }
+  pin_levels[pin] = level;
+  for (size_t i = 0; i < listeners.size(); i++) {
+    listeners[i]->pinChanged(pin, level);
+  }
+}
+
+int host_pin(int pin) {
+  return ((pin >= 0) && (pin < HOST_PINS)) ? pin_levels[pin] : LOW;
+}
+
+void host_spi_byte(uint8_t value) {
+  for (size_t i = 0; i < listeners.size(); i++) {
+    listeners[i]->spiByte(value);
+  }
+}
+
+#ifdef HOST_SAMD_DMA
+void SPIClass::transfer(const void *txbuf, void *, size_t count, bool block) {
+  waitForTransfer();
+  transfers++;
+  dma_data = (const uint8_t *)txbuf;
+  dma_left = count;
+  if (block) {
+    waitForTransfer();
+  }
+}
+
+void SPIClass::waitForTransfer(void) {
+  while (isBusy()) {
+  }
+}
+
+bool SPIClass::isBusy(void) {
+  for (int i = 0; (i < HOST_DMA_STEP) && dma_left; i++, dma_left--) {
+    host_spi_byte(*dma_data++);
+    host_advance(800);
+  }
+  return dma_left > 0;
+}
+#endif
+
+void host_advance(uint32_t ns) { now_ns += ns; }
+
+uint64_t host_nanos(void) { return now_ns; }
+
+void host_interrupt(int pin) {
+  if ((pin >= 0) && (pin < HOST_PINS) && interrupt_handlers[pin]) {
+    interrupt_handlers[pin]();
+  }
+}
+
+void pinMode(int, int) {}
+
+void digitalWrite(int pin, int level) {
+  host_advance(HOST_DIGITALWRITE_NS);
+  host_set_pin(pin, level ? HIGH : LOW);
+}
+
+int digitalRead(int pin) { return host_pin(pin); }
+
+void delay(unsigned long ms) { now_ns += ms * 1000000ULL; }
+
+void delayMicroseconds(unsigned int us) { now_ns += us * 1000ULL; }
+
+void delayNanoseconds(unsigned int ns) { now_ns += ns; }
+
+// Reading the clock takes a little time, so that busy-wait loops end.
+unsigned long micros(void) {
+  now_ns += HOST_MICROS_NS;
+  return (unsigned long)(uint32_t)(now_ns / 1000);
+}
+
+unsigned long millis(void) {
+  now_ns += HOST_MICROS_NS;
+  return (unsigned long)(uint32_t)(now_ns / 1000000);
+}
+
+void yield(void) {}
+
+void attachInterrupt(int interrupt, void (*isr)(void), int) {
+  if ((interrupt >= 0) && (interrupt < HOST_PINS)) {
+    interrupt_handlers[interrupt] = isr;
+  }
+}
+
+void detachInterrupt(int interrupt) {
+  if ((interrupt >= 0) && (interrupt < HOST_PINS)) {
+    interrupt_handlers[interrupt] = NULL;
+  }
+}
+
+#ifdef HOST_FAST_PINIO
+static HostPort *ports[HOST_PINS / 8];
+
+HostPort *portOutputRegister(uint8_t port) {
+  if (!ports[port]) {
+    ports[port] = new HostPort(port);
+  }
+  return ports[port];
+}
+
+HostPort::operator uint8_t() const {
+  uint8_t value = 0;
+  for (int bit = 0; bit < 8; bit++) {
+    value |= host_pin(index * 8 + bit) << bit;
+  }
+  return value;
+}
+
+HostPort &HostPort::operator=(uint8_t value) {
+  host_advance(HOST_PORTWRITE_NS);
+  for (int bit = 0; bit < 8; bit++) {
+    host_set_pin(index * 8 + bit, (value >> bit) & 1);
+  }
+  return *this;
+}
+#endif
@@ -0,0 +1,40 @@
+// Hooks into the host Arduino core, for the emulated controllers and tests.
+
+#ifndef HOST_HOST_H
+#define HOST_HOST_H
+
+#include "Arduino.h"
+
+// Something on the bus that watches pin changes and hardware SPI bytes.
+// Listeners add themselves with host_listen() and see every pin change,
+// whichever way it was made (digitalWrite() or a port register).
+class HostListener {
+public:
+  virtual ~HostListener() {}
+  virtual void pinChanged(int pin, int level) = 0;
+  virtual void spiByte(uint8_t value) = 0;
+};
+
+void host_listen(HostListener *listener);
+void host_unlisten(HostListener *listener);
+
+// Set a pin's level and tell the listeners if it changed.
+void host_set_pin(int pin, int level);
+int host_pin(int pin);
+
+// A byte clocked out of the hardware SPI port.
+void host_spi_byte(uint8_t value);
+
+// Simulated time, in nanoseconds since start.
+void host_advance(uint32_t ns);
+uint64_t host_nanos(void);
+
+// Run the interrupt handler attached to a pin, if any.
+void host_interrupt(int pin);
+
+// Time taken by a digitalWrite(), a port register write and a micros() call.
+#define HOST_DIGITALWRITE_NS 300
+#define HOST_PORTWRITE_NS 20
+#define HOST_MICROS_NS 100
+
+#endif // HOST_HOST_H
@@ -0,0 +1,56 @@
+// displayAsync(): the panel gets the frame as it was when the update
+// started, however much is drawn while it is being sent, and commands sent
+// while it is going out wait for it. In the dma build the rows go out as
+// background transfers.
+
+#include "harness.h"
+
+int main() {
+  static uint8_t snapshot[8192];
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    for (int shadow = 0; shadow < 2; shadow++) {
+      Emulator emu(sh1122, TEST_DC, TEST_CS);
+      Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+      EXPECT(display.begin(), "begin() failed");
+      if (shadow) {
+        display.enableShadowBuffer();
+      }
+      EXPECT(display.enableAsyncDisplay(), "no back buffer");
+      srand(3);
+      for (int i = 0; i < 100; i++) {
+        for (int k = 0; k < 3; k++) {
+          display.fillRect(rand() % 256, rand() % 64, rand() % 80, rand() % 30,
+                           rand() & 15);
+        }
+        display.displayAsync();
+        memcpy(snapshot, display.getBuffer(), sizeof(snapshot));
+        while (display.isBusy()) {
+          display.fillRect(rand() % 256, rand() % 64, 5, 5, rand() & 15);
+        }
+        expect_panel(emu, snapshot, "async update");
+        if (i % 10 == 5) {
+          // Commands in the middle of an update wait for it to finish.
+          display.fillRect(0, 0, 256, 64, i & 15);
+          display.displayAsync();
+          memcpy(snapshot, display.getBuffer(), sizeof(snapshot));
+          display.isBusy();
+          display.setContrast(0x40 + i);
+          display.invertDisplay(i & 1);
+          display.waitForDisplay();
+          expect_panel(emu, snapshot, "commands during an update");
+        }
+        if (i % 10 == 0) {
+          display.display();
+          expect_panel(emu, display.getBuffer(), "display() between");
+        }
+      }
+#ifdef HOST_SAMD_DMA
+      EXPECT(SPI.transfers > 0, "no background transfers");
+      SPI.transfers = 0;
+#endif
+      EXPECT(!emu.errors, "bus errors");
+      printf("%s%s ok\n", controller(sh1122), shadow ? " with shadow" : "");
+    }
+  }
+  printf("async ok\n");
+}
@@ -0,0 +1,92 @@
+// beginBanded()/renderBands(): drawing a scene a band at a time gives the
+// same panel contents as drawing it into a whole frame buffer, and each
+// pass is an update like display().
+
+#include "harness.h"
+
+static void scene(Adafruit_SSD1322 &display, void *) {
+  srand(5);
+  for (int i = 0; i < 200; i++) {
+    int x = rand() % 300 - 20, y = rand() % 100 - 20;
+    int w = rand() % 80 + 1, h = rand() % 40 + 1, color = rand() & 15;
+    switch (rand() % 5) {
+    case 0:
+      display.fillRect(x, y, w, h, color);
+      break;
+    case 1:
+      display.drawLine(x, y, x + w, y + h, color);
+      break;
+    case 2:
+      display.drawRect(x, y, w, h, color);
+      break;
+    case 3:
+      display.setCursor(x, y);
+      display.setTextColor(color);
+      display.print("Hi band");
+      break;
+    default:
+      display.drawFastVLine(x, y, h, color);
+      break;
+    }
+  }
+}
+
+int main() {
+  static uint8_t whole[8192];
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    {
+      Emulator emu(sh1122, TEST_DC, TEST_CS);
+      Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+      EXPECT(display.begin(), "begin() failed");
+      scene(display, NULL);
+      memcpy(whole, display.getBuffer(), sizeof(whole));
+    }
+    for (int rows = 1; rows <= 64; rows = rows * 3 + 1) {
+      Emulator emu(sh1122, TEST_DC, TEST_CS);
+      Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+      EXPECT(display.beginBanded(rows), "beginBanded(%d) failed", rows);
+      emu.resetCounts();
+      display.renderBands(scene);
+      EXPECT(!emu.compare(whole, 256, 64), "%s, %d-row bands",
+             controller(sh1122), rows);
+      printf("%s, %d-row bands: %ld bytes\n", controller(sh1122), rows,
+             emu.bytes);
+    }
+
+    // Each renderBands() is an update like display(): counted, paced and
+    // waking the panel, with display() in between checking the idle
+    // timeouts and pixel shift.
+    Emulator emu(sh1122, TEST_DC, TEST_CS);
+    Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+    EXPECT(display.beginBanded(16), "beginBanded(16) failed");
+    EXPECT(display.enableStats(), "no stats");
+    const Adafruit_SSD1322::Stats *stats = display.getStats();
+    display.setMaxFrameRate(10);
+    display.renderBands(scene);
+    display.renderBands(scene);
+    EXPECT((stats->frames == 1) && (stats->skipped == 1),
+           "%u band updates, %u put off", (unsigned)stats->frames,
+           (unsigned)stats->skipped);
+    EXPECT(stats->bytes >= 8192, "%u bytes counted", (unsigned)stats->bytes);
+    delay(1000);
+    display.renderBands(scene);
+    EXPECT(stats->frames == 2, "band update not sent after the wait");
+    EXPECT(!emu.compare(whole, 256, 64), "%s, paced bands", controller(sh1122));
+    display.setMaxFrameRate(0);
+
+    display.setIdleTimeouts(1);
+    delay(1500);
+    display.display();
+    EXPECT(display.getIdleStage() == Adafruit_SSD1322::IDLE_DIM,
+           "not dimmed in band mode");
+    display.renderBands(scene);
+    EXPECT(display.getIdleStage() == Adafruit_SSD1322::IDLE_ACTIVE,
+           "not woken by renderBands()");
+    display.setIdleTimeouts(0);
+    display.setPixelShift(2, 1);
+    delay(1000);
+    display.display();
+    EXPECT(emu.display_offset == 1, "no pixel shift in band mode");
+  }
+  printf("band ok\n");
+}
@@ -0,0 +1,48 @@
+// Random drawing, each followed by display(): the panel must always end up
+// showing the frame buffer, with and without the shadow buffer.
+
+#include "harness.h"
+
+static void run(bool sh1122, bool shadow) {
+  Emulator emu(sh1122, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+  EXPECT(display.begin(), "begin() failed");
+  if (shadow) {
+    EXPECT(display.enableShadowBuffer(), "no shadow buffer");
+  }
+  display.display();
+  expect_panel(emu, display.getBuffer(), "first update");
+
+  srand(1);
+  for (int i = 0; i < 200; i++) {
+    int x = rand() % 300 - 20, y = rand() % 80 - 8;
+    int w = rand() % 60, h = rand() % 30;
+    switch (rand() % 4) {
+    case 0:
+      display.fillRect(x, y, w, h, rand() & 15);
+      break;
+    case 1:
+      display.drawPixel(x, y, rand() & 15);
+      break;
+    case 2:
+      display.drawLine(x, y, x + w, y + h, rand() & 15);
+      break;
+    default:
+      display.drawRect(x, y, w, h, rand() & 15);
+      display.drawPixel(rand() % 256, rand() % 64, 7);
+      break;
+    }
+    display.display();
+    expect_panel(emu, display.getBuffer(), "update");
+  }
+  EXPECT(!emu.errors, "%ld bus errors", emu.errors);
+  printf("%s%s ok\n", controller(sh1122), shadow ? " with shadow" : "");
+}
+
+int main() {
+  run(false, false);
+  run(true, false);
+  run(false, true);
+  run(true, true);
+  printf("basic ok\n");
+}
@@ -0,0 +1,144 @@
+// Canvases and compositeLayers(): canvas drawing in every rotation, each
+// blend mode against a per-pixel reference, a small change to a layer
+// costing a small update, and moving a layer without invalidating it.
+
+#include "harness.h"
+
+#include <Adafruit_SSD1322_Canvas.h>
+
+static void set_nibble(uint8_t *buffer, int stride, int x, int y, int level) {
+  uint8_t &b = buffer[y * stride + x / 2];
+  b = (x & 1) ? ((b & 0xF0) | level) : ((b & 0x0F) | (level << 4));
+}
+
+// Composite layers pixel by pixel onto a black 256x64 frame.
+static void composite(uint8_t *frame, const Adafruit_SSD1322_Layer *layers,
+                      int count) {
+  memset(frame, 0, 8192);
+  for (int l = 0; l < count; l++) {
+    const Adafruit_SSD1322_Layer &layer = layers[l];
+    Adafruit_SSD1322_Canvas *canvas = layer.canvas;
+    for (int y = 0; y < canvas->height(); y++) {
+      for (int x = 0; x < canvas->width(); x++) {
+        int fx = x + layer.x, fy = y + layer.y;
+        if ((fx < 0) || (fy < 0) || (fx >= 256) || (fy >= 64)) {
+          continue;
+        }
+        int src = nibble(canvas->getBuffer(), canvas->getStride(), x, y);
+        int dst = nibble(frame, 128, fx, fy);
+        int out;
+        switch (layer.mode) {
+        case SSD1322_BLEND_COPY:
+          out = src;
+          break;
+        case SSD1322_BLEND_KEY:
+          out = (src == layer.value) ? dst : src;
+          break;
+        case SSD1322_BLEND_MAX:
+          out = max(src, dst);
+          break;
+        case SSD1322_BLEND_ADD:
+          out = min(src + dst, 15);
+          break;
+        default: {
+          int alpha = layer.mask ? nibble(layer.mask->getBuffer(),
+                                          layer.mask->getStride(), x, y)
+                                 : layer.value;
+          out = (src * alpha + dst * (15 - alpha) + 7) / 15;
+          break;
+        }
+        }
+        set_nibble(frame, 128, fx, fy, out);
+      }
+    }
+  }
+}
+
+int main() {
+  static uint8_t expected[8192];
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  Adafruit_SSD1322_Canvas background(256, 64), sprite(61, 23), overlay(40, 30),
+      mask(40, 30);
+
+  srand(5);
+  for (int rotation = 0; rotation < 4; rotation++) {
+    sprite.setRotation(rotation);
+    for (int i = 0; i < 300; i++) {
+      int x = rand() % 80 - 10, y = rand() % 80 - 10;
+      int w = rand() % 30 + 1, h = rand() % 30 + 1, color = rand() & 15;
+      sprite.fillRect(x, y, w, h, color);
+      for (int py = max(y, 0); py < min(y + h, (int)sprite.height()); py++) {
+        for (int px = max(x, 0); px < min(x + w, (int)sprite.width()); px++) {
+          EXPECT(sprite.getPixel(px, py) == color, "canvas rotation %d",
+                 rotation);
+        }
+      }
+    }
+  }
+  sprite.setRotation(0);
+
+  for (int i = 0; i < 400; i++) {
+    for (int k = 0; k < 3; k++) {
+      Adafruit_SSD1322_Canvas *canvas =
+          (k == 0) ? &background : (k == 1) ? &sprite : (rand() % 2) ? &overlay : &mask;
+      if (rand() % 3 == 0) {
+        canvas->fillRect(rand() % canvas->width(), rand() % canvas->height(),
+                         rand() % 20 + 1, rand() % 10 + 1, rand() & 15);
+      }
+      if (rand() % 4 == 0) {
+        canvas->drawPixel(rand() % canvas->width(), rand() % canvas->height(),
+                          rand() & 15);
+      }
+    }
+    Adafruit_SSD1322_Layer layers[3] = {
+        {&background, 0, 0, SSD1322_BLEND_COPY, 0, NULL},
+        {&sprite, int16_t(rand() % 260 - 20), int16_t(rand() % 70 - 10),
+         uint8_t(rand() % 5), uint8_t(rand() & 15), NULL},
+        {&overlay, int16_t(rand() % 260 - 20), int16_t(rand() % 70 - 10),
+         uint8_t(rand() % 5), uint8_t(rand() & 15),
+         (rand() % 2) ? &mask : NULL}};
+    // The blend modes change every time, so redraw everything.
+    background.invalidate();
+    display.compositeLayers(layers, 3);
+    composite(expected, layers, 3);
+    EXPECT(!memcmp(expected, display.getBuffer(), 8192),
+           "composite %d, modes %d and %d", i, layers[1].mode, layers[2].mode);
+    if (i % 50 == 0) {
+      display.display();
+      expect_panel(emu, display.getBuffer(), "update");
+    }
+  }
+
+  // Still layers: nothing to do, then one changed pixel
+  Adafruit_SSD1322_Layer still[2] = {
+      {&background, 0, 0, SSD1322_BLEND_COPY, 0, NULL},
+      {&sprite, 100, 20, SSD1322_BLEND_KEY, 0, NULL}};
+  display.compositeLayers(still, 2);
+  display.display();
+  emu.resetCounts();
+  display.compositeLayers(still, 2);
+  display.display();
+  EXPECT(emu.bytes == 0, "%ld bytes sent with nothing changed", emu.bytes);
+  sprite.drawPixel(3, 3, 9);
+  emu.resetCounts();
+  display.compositeLayers(still, 2);
+  display.display();
+  printf("one pixel: %ld bytes\n", emu.bytes);
+  EXPECT(emu.bytes < 64, "%ld bytes for one pixel", emu.bytes);
+  expect_panel(emu, display.getBuffer(), "one pixel");
+
+  // Moving layers leave nothing behind.
+  for (int i = 0; i < 20; i++) {
+    still[1].x = rand() % 260 - 20;
+    still[1].y = rand() % 70 - 10;
+    display.compositeLayers(still, 2);
+    composite(expected, still, 2);
+    EXPECT(!memcmp(expected, display.getBuffer(), 8192), "moved to %d,%d",
+           still[1].x, still[1].y);
+  }
+  display.display();
+  expect_panel(emu, display.getBuffer(), "moved layer");
+  printf("canvas ok\n");
+}
@@ -0,0 +1,57 @@
+// The byte-wide fill primitives against GFX's pixel-by-pixel drawing, in
+// every rotation.
+
+#include "harness.h"
+
+int main() {
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  Reference ref;
+  srand(11);
+  for (int rotation = 0; rotation < 4; rotation++) {
+    display.setRotation(rotation);
+    ref.setRotation(rotation);
+    for (int i = 0; i < 2000; i++) {
+      int kind = rand() % 6;
+      int x = rand() % 300 - 20, y = rand() % 300 - 20;
+      int w = rand() % 80 + 1, h = rand() % 40 + 1, color = rand() & 15;
+      switch (kind) {
+      case 0:
+        display.fillRect(x, y, w, h, color);
+        ref.fillRect(x, y, w, h, color);
+        break;
+      case 1:
+        display.drawFastHLine(x, y, w, color);
+        ref.drawFastHLine(x, y, w, color);
+        break;
+      case 2:
+        display.drawFastVLine(x, y, h, color);
+        ref.drawFastVLine(x, y, h, color);
+        break;
+      case 3:
+        if (i % 50 == 0) {
+          display.fillScreen(color);
+          ref.fillScreen(color);
+        }
+        break;
+      case 4:
+        display.drawRect(x, y, w, h, color);
+        ref.drawRect(x, y, w, h, color);
+        break;
+      default:
+        display.drawLine(x, y, x + w, y + h, color);
+        ref.drawLine(x, y, x + w, y + h, color);
+        break;
+      }
+      EXPECT(!memcmp(display.getBuffer(), ref.getBuffer(), 8192),
+             "rotation %d, draw %d (kind %d at %d,%d %dx%d)", rotation, i, kind,
+             x, y, w, h);
+      if (i % 100 == 0) {
+        display.display();
+        expect_panel(emu, display.getBuffer(), "update");
+      }
+    }
+  }
+  printf("draw ok\n");
+}
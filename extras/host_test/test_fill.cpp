@@ -0,0 +1,38 @@
+// Uniform runs sent as constant fills: the panel still matches, and a
+// cleared screen costs no more than a full frame.
+
+#include "harness.h"
+
+int main() {
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    Emulator emu(sh1122, TEST_DC, TEST_CS);
+    Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+    EXPECT(display.begin(), "begin() failed");
+    display.display();
+    emu.resetCounts();
+    display.clearDisplay();
+    display.display();
+    printf("%s clear: %ld bytes\n", controller(sh1122), emu.bytes);
+    EXPECT(emu.bytes < 8192 + 64 * 4, "clear took %ld bytes", emu.bytes);
+    expect_panel(emu, display.getBuffer(), "clear");
+
+    srand(1);
+    for (int i = 0; i < 200; i++) {
+      for (int k = rand() % 4; k > 0; k--) {
+        display.fillRect(rand() % 256, rand() % 64, rand() % 100 + 1,
+                         rand() % 30 + 1, rand() % 16);
+      }
+      if (rand() % 3 == 0) {
+        for (int k = 0; k < 20; k++) {
+          display.drawPixel(rand() % 256, rand() % 64, rand() % 16);
+        }
+      }
+      if (i == 100) {
+        display.enableShadowBuffer();
+      }
+      display.display();
+      expect_panel(emu, display.getBuffer(), "update");
+    }
+  }
+  printf("fill ok\n");
+}
@@ -0,0 +1,17 @@
+// Panels narrower than the controller's RAM.
+
+#include "harness.h"
+
+int main() {
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(128, 64, &SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  srand(5);
+  for (int i = 0; i < 100; i++) {
+    display.fillRect(rand() % 140 - 5, rand() % 70 - 3, rand() % 40,
+                     rand() % 20, rand() & 15);
+    display.display();
+    EXPECT(!emu.compare(display.getBuffer(), 128, 64), "128x64 update %d", i);
+  }
+  printf("geometry ok\n");
+}
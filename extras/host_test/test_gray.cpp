@@ -0,0 +1,109 @@
+// Grayscale images: drawGrayBitmap4/8 against per-pixel drawing, dithering
+// within one level of the exact value, and streaming straight to the panel.
+
+#include "harness.h"
+
+static uint8_t image[40000];
+
+int main() {
+  srand(3);
+  for (size_t i = 0; i < sizeof(image); i++) {
+    image[i] = rand();
+  }
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  Reference ref;
+  for (int i = 0; i < 2000; i++) {
+    int x = rand() % 300 - 30, y = rand() % 100 - 30;
+    int w = rand() % 60 + 1, h = rand() % 30 + 1;
+    const uint8_t *src = image + rand() % 1000;
+    int kind = rand() % 3;
+    if (kind == 0) {
+      display.drawGrayBitmap4(x, y, src, w, h);
+      int stride = (w + 1) / 2;
+      for (int j = 0; j < h; j++) {
+        for (int k = 0; k < w; k++) {
+          ref.drawPixel(x + k, y + j, nibble(src, stride, k, j));
+        }
+      }
+    } else if (kind == 1) {
+      display.drawGrayBitmap8(x, y, src, w, h);
+      for (int j = 0; j < h; j++) {
+        for (int k = 0; k < w; k++) {
+          ref.drawPixel(x + k, y + j,
+                        (((src[j * w + k] * 240 + 127) / 255) + 8) >> 4);
+        }
+      }
+    } else {
+      display.drawGrayBitmap8(x, y, src, w, h, true);
+      for (int j = 0; j < h; j++) {
+        for (int k = 0; k < w; k++) {
+          int px = x + k, py = y + j;
+          if ((px < 0) || (py < 0) || (px >= 256) || (py >= 64)) {
+            continue;
+          }
+          int level = nibble(display.getBuffer(), 128, px, py);
+          float exact = src[j * w + k] * 15 / 255.0f;
+          EXPECT((level >= exact - 1) && (level <= exact + 1),
+                 "dithered level %d for %.2f", level, exact);
+          ref.drawPixel(px, py, level);
+        }
+      }
+    }
+    EXPECT(!memcmp(display.getBuffer(), ref.getBuffer(), 8192),
+           "image %d (kind %d at %d,%d %dx%d)", i, kind, x, y, w, h);
+  }
+
+  display.display();
+  display.enableShadowBuffer();
+  display.display();
+  for (int i = 0; i < 50; i++) {
+    int x = (rand() % 60) * 4, y = rand() % 64;
+    int w = (rand() % 16 + 1) * 4, h = rand() % 20 + 1;
+    if ((x + w > 256) || (y + h > 64)) {
+      continue;
+    }
+    if (i == 10) {
+      display.scrollVertical(13);
+      display.display();
+    }
+    EXPECT(display.streamGrayBitmap4(x, y, image, w, h), "stream failed");
+    for (int j = 0; j < h; j++) {
+      for (int k = 0; k < w / 2; k++) {
+        EXPECT(emu.visible(y + j, x / 2 + k, 256) == image[j * (w / 2) + k],
+               "streamed image %d at %d,%d", i, x, y);
+      }
+    }
+  }
+  EXPECT(!display.streamGrayBitmap4(2, 0, image, 8, 8),
+         "unaligned stream accepted");
+
+  // Streaming counts as an update, and only works in the rotations the
+  // controller turns round itself.
+  EXPECT(display.enableStats(), "no stats");
+  const Adafruit_SSD1322::Stats *stats = display.getStats();
+  display.setRotation(1);
+  EXPECT(!display.streamGrayBitmap4(0, 0, image, 8, 8),
+         "stream accepted in rotation 1");
+  display.setRotation(2);
+  EXPECT(!display.streamGrayBitmap4(0, 0, image, 8, 8),
+         "stream accepted in rotation 2 without the hardware flip");
+  EXPECT(stats->frames == 0, "%lu frames for rejected streams",
+         (unsigned long)stats->frames);
+  display.setHardwareFlip(true);
+  display.display();
+  uint32_t frames = stats->frames;
+  EXPECT(display.streamGrayBitmap4(16, 8, image, 32, 16),
+         "stream failed in rotation 2 with the hardware flip");
+  EXPECT(stats->frames == frames + 1, "stream not counted as a frame");
+  EXPECT(stats->windows > 0, "stream windows not counted");
+  static uint8_t streamed[128][256];
+  memcpy(streamed, emu.ram, sizeof(streamed));
+  display.drawGrayBitmap4(16, 8, image, 32, 16);
+  display.display();
+  EXPECT(!memcmp(streamed, emu.ram, sizeof(streamed)),
+         "stream and drawGrayBitmap4() differ in rotation 2");
+  display.setHardwareFlip(false);
+  printf("gray ok\n");
+}
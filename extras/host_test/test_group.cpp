@@ -0,0 +1,88 @@
+// Adafruit_SSD1322_Group: four panels sharing DC as a 2x2 wall, drawn in
+// every rotation against one big reference canvas.
+
+#include "harness.h"
+
+#include <Adafruit_SSD1322_Group.h>
+
+int main() {
+  Emulator *panels[4];
+  Adafruit_SSD1322 *displays[4];
+  for (int i = 0; i < 4; i++) {
+    panels[i] = new Emulator(false, TEST_DC, 20 + i);
+    displays[i] = new Adafruit_SSD1322(&SPI, TEST_DC, -1, 20 + i);
+  }
+  Adafruit_SSD1322_Group group(displays, 2, 2);
+  EXPECT(group.begin(), "begin() failed");
+  EXPECT((group.width() == 512) && (group.height() == 128), "wall size %dx%d",
+         group.width(), group.height());
+  Reference ref(512, 128);
+
+  srand(3);
+  static uint8_t tile[8192];
+  for (int rotation = 0; rotation < 4; rotation++) {
+    group.setRotation(rotation);
+    ref.setRotation(rotation);
+    for (int i = 0; i < 400; i++) {
+      int x = rand() % 600 - 40, y = rand() % 600 - 40;
+      int w = rand() % 200 + 1, h = rand() % 100 + 1, color = rand() & 15;
+      switch (rand() % 5) {
+      case 0:
+        group.fillRect(x, y, w, h, color);
+        ref.fillRect(x, y, w, h, color);
+        break;
+      case 1:
+        group.drawLine(x, y, x + w, y - h, color);
+        ref.drawLine(x, y, x + w, y - h, color);
+        break;
+      case 2:
+        group.drawRect(x, y, w, h, color);
+        ref.drawRect(x, y, w, h, color);
+        break;
+      case 3:
+        group.setCursor(x % 300, y % 100);
+        group.setTextColor(color);
+        group.print("Wall!");
+        ref.setCursor(x % 300, y % 100);
+        ref.setTextColor(color);
+        ref.print("Wall!");
+        break;
+      default:
+        group.drawFastHLine(x, y, w, color);
+        ref.drawFastHLine(x, y, w, color);
+        break;
+      }
+      if (i % 37 == 0) {
+        group.display();
+        for (int p = 0; p < 4; p++) {
+          for (int row = 0; row < 64; row++) {
+            memcpy(tile + row * 128,
+                   ref.getBuffer() + ((p / 2) * 64 + row) * 256 + (p % 2) * 128,
+                   128);
+          }
+          EXPECT(!panels[p]->compare(tile, 256, 64),
+                 "panel %d, rotation %d, draw %d", p, rotation, i);
+        }
+      }
+    }
+  }
+
+  // A change on one panel is only sent to that one.
+  group.setRotation(0);
+  group.display();
+  for (int p = 0; p < 4; p++) {
+    panels[p]->resetCounts();
+  }
+  group.fillRect(300, 10, 8, 8, 15);
+  group.display();
+  printf("bytes per panel: %ld %ld %ld %ld\n", panels[0]->bytes,
+         panels[1]->bytes, panels[2]->bytes, panels[3]->bytes);
+  EXPECT(!panels[0]->bytes && panels[1]->bytes && !panels[2]->bytes &&
+             !panels[3]->bytes,
+         "change sent to the wrong panels");
+  for (int i = 0; i < 4; i++) {
+    delete displays[i];
+    delete panels[i];
+  }
+  printf("group ok\n");
+}
@@ -0,0 +1,54 @@
+// Idle power saving steps down through dim, slow and sleep while nothing
+// changes, and wakes on the next change; pixel shift moves the picture
+// periodically.
+
+#include "harness.h"
+
+int main() {
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    Emulator emu(sh1122, TEST_DC, TEST_CS);
+    Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+    EXPECT(display.begin(), "begin() failed");
+    display.display();
+    display.setIdleTimeouts(10, 20, 30);
+
+    const uint8_t stages[] = {Adafruit_SSD1322::IDLE_DIM,
+                              Adafruit_SSD1322::IDLE_SLOW,
+                              Adafruit_SSD1322::IDLE_SLEEP};
+    // One second before and after each timeout
+    for (int s = 0; s < 3; s++) {
+      delay(s ? 8000 : 9000);
+      display.display();
+      EXPECT(display.getIdleStage() == stages[s] - 1, "%s stage %d too early",
+             controller(sh1122), stages[s]);
+      delay(2000);
+      emu.resetCounts();
+      display.display();
+      EXPECT(display.getIdleStage() == stages[s], "%s stage %d not reached",
+             controller(sh1122), stages[s]);
+      EXPECT(emu.commands > 0, "no commands for stage %d", stages[s]);
+    }
+    EXPECT(!emu.on, "%s still on when asleep", controller(sh1122));
+
+    display.fillRect(0, 0, 8, 2, 15);
+    display.display();
+    EXPECT(display.getIdleStage() == Adafruit_SSD1322::IDLE_ACTIVE,
+           "not woken");
+    EXPECT(emu.on, "%s not on after waking", controller(sh1122));
+    expect_panel(emu, display.getBuffer(), "after waking");
+
+    display.setPixelShift(2, 1);
+    int moves = 0;
+    for (int i = 0; i < 6; i++) {
+      delay(1000);
+      emu.resetCounts();
+      display.display();
+      if (emu.commands) {
+        moves++;
+      }
+    }
+    printf("%s: %d pixel shifts in 6 s\n", controller(sh1122), moves);
+    EXPECT(moves >= 5, "%d pixel shifts in 6 s", moves);
+  }
+  printf("idle ok\n");
+}
@@ -0,0 +1,48 @@
+// Gray scale tables and the luminance curve.
+
+#include "harness.h"
+
+int main() {
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+
+  emu.resetCounts();
+  EXPECT(display.setGrayTableGamma(2.2), "gamma table refused");
+  // 0xB8, 15 table entries, 0x00 (enable the table)
+  EXPECT((emu.log.size() == 17) && (emu.log[0] == 0xB8), "gray table command");
+  for (int i = 2; i < 16; i++) {
+    EXPECT(emu.log[i] > emu.log[i - 1], "gray table not increasing");
+  }
+  EXPECT(!display.setGrayTableGamma(0), "gamma 0 accepted");
+  EXPECT(!display.setGrayTableGamma(-1), "negative gamma accepted");
+  uint8_t bad[15] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 13, 14};
+  EXPECT(!display.setGrayTable(bad), "non-increasing table accepted");
+
+  for (int v = 0; v < 256; v++) {
+    EXPECT(display.luminanceToGray(v) == (((v * 240 + 127) / 255 + 8) >> 4),
+           "linear luminance %d", v);
+  }
+  EXPECT(display.setLuminanceGamma(2.2), "gamma refused");
+  uint8_t ramp[256];
+  for (int i = 0; i < 256; i++) {
+    ramp[i] = i;
+  }
+  display.drawGrayBitmap8(0, 0, ramp, 256, 1);
+  for (int x = 0; x < 256; x++) {
+    EXPECT(nibble(display.getBuffer(), 128, x, 0) == display.luminanceToGray(x),
+           "image drawn with the curve at %d", x);
+    if (x) {
+      EXPECT(display.luminanceToGray(x) >= display.luminanceToGray(x - 1),
+             "curve not monotonic at %d", x);
+    }
+  }
+  EXPECT(display.luminanceToGray(128) < 8, "gamma 2.2 curve too bright");
+  display.setLuminanceGamma(1.0);
+
+  Emulator emu2(true, TEST_DC, 12);
+  Adafruit_SSD1322 sh1122(&SPI, TEST_DC, -1, 12, variant(true));
+  EXPECT(sh1122.begin(), "begin() failed");
+  EXPECT(!sh1122.setGrayTableGamma(2.2), "SH1122 took a gray table");
+  printf("lut ok\n");
+}
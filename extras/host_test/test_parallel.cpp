@@ -0,0 +1,58 @@
+// The 8-bit parallel bus, in both protocols, with D0-D7 on consecutive
+// bits of one port and scattered, kept within the controllers' write
+// timing. The fastpin builds drive it through the port registers.
+
+#include "harness.h"
+
+#include <Adafruit_SSD1322_Parallel.h>
+
+#define TEST_WR 30
+#define TEST_RD 33
+#define TEST_PAR_DC 31
+#define TEST_PAR_CS 32
+
+int main() {
+  // D0-D7 on bits 0-7 of port 2, and the same pins in reverse order
+  const int8_t in_order[8] = {16, 17, 18, 19, 20, 21, 22, 23};
+  const int8_t reversed[8] = {23, 22, 21, 20, 19, 18, 17, 16};
+  for (int mode = 0; mode < 2; mode++) {
+    for (int scattered = 0; scattered < 2; scattered++) {
+      for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+        const int8_t *pins = scattered ? reversed : in_order;
+        Emulator emu(sh1122, TEST_PAR_DC, TEST_PAR_CS);
+        emu.connectParallel(pins, TEST_WR, TEST_RD, mode);
+        Adafruit_SSD1322_Parallel bus(pins, TEST_WR, TEST_RD, TEST_PAR_DC,
+                                      TEST_PAR_CS, mode);
+        Adafruit_SSD1322 display(&bus, -1, variant(sh1122));
+        EXPECT(display.begin(), "begin() failed");
+        EXPECT(emu.on, "%s not turned on", controller(sh1122));
+        srand(5);
+        for (int i = 0; i < 40; i++) {
+          for (int k = 0; k < 3; k++) {
+            display.fillRect(rand() % 256, rand() % 64, rand() % 100 + 1,
+                             rand() % 30 + 1, rand() % 16);
+          }
+          for (int k = 0; k < 20; k++) {
+            display.drawPixel(rand() % 256, rand() % 64, rand() % 16);
+          }
+          if (i == 10) {
+            display.clearDisplay();
+          }
+          display.display();
+          expect_panel(emu, display.getBuffer(), "update");
+        }
+        // The superclass's command helpers would need an SPI device.
+        long commands = emu.commands;
+        display.oled_command(0xA6);
+        const uint8_t list[] = {0xA7, 0xA6};
+        display.oled_commandList(list, 2);
+        EXPECT(emu.commands == commands + 3, "oled_command() over the bus");
+        EXPECT(!emu.errors, "%ld bus errors", emu.errors);
+        printf("%s, %s, %s pins: %ld bytes\n", mode ? "6800" : "8080",
+               controller(sh1122), scattered ? "scattered" : "consecutive",
+               emu.bytes);
+      }
+    }
+  }
+  printf("parallel ok\n");
+}
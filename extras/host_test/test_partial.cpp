@@ -0,0 +1,114 @@
+// enablePartialDisplay(): a 16-row status strip at the bottom of the panel
+// with a frame buffer of its own, through plain, shadow and async updates,
+// after a scroll, through a hardware flip, and back to the full panel.
+
+#include "harness.h"
+
+// Check that the panel shows the strip from row y of the scan, and leaves
+// every other row dark.
+static void expect_strip(Emulator &emu, Adafruit_SSD1322 &display, int y,
+                         const char *what) {
+  static uint8_t frame[8192];
+  memset(frame, 0, sizeof(frame));
+  memcpy(frame + y * 128, display.getBuffer(),
+         display.getPartialRows() * 128);
+  expect_panel(emu, frame, what);
+}
+
+int main() {
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    Emulator emu(sh1122, TEST_DC, TEST_CS);
+    Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+    EXPECT(display.begin(), "begin() failed");
+    display.fillRect(0, 0, 256, 64, 3);
+    display.display();
+    // Changes not yet sent, one partly inside the strip and one outside it
+    display.fillRect(10, 50, 20, 4, 9);
+    display.fillRect(10, 5, 20, 4, 9);
+
+    EXPECT(display.enablePartialDisplay(48, 16), "enablePartialDisplay failed");
+    EXPECT(display.getPartialRows() == 16, "strip rows");
+    display.display();
+    expect_strip(emu, display, 48, "pending changes");
+
+    display.fillScreen(0);
+    display.setCursor(0, 50);
+    display.setTextColor(15);
+    display.print("status 42");
+    display.drawLine(0, 0, 255, 63, 7);
+    display.drawPixel(3, 60, 11);
+    EXPECT(display.getPixel(3, 60) == 11, "getPixel() in the strip");
+    EXPECT(display.getPixel(10, 5) == 0, "getPixel() above the strip");
+    emu.resetCounts();
+    display.display();
+    printf("%s strip update: %ld bytes\n", controller(sh1122), emu.bytes);
+    EXPECT(emu.bytes <= 16 * 128 + 64, "strip update took %ld bytes",
+           emu.bytes);
+    expect_strip(emu, display, 48, "text");
+
+    display.scrollVertical(4);
+    EXPECT(display.enableShadowBuffer(), "no shadow buffer");
+    display.enableAsyncDisplay();
+    display.fillRect(100, 60, 5, 2, 12);
+    display.displayAsync();
+    display.waitForDisplay();
+    expect_strip(emu, display, 48, "async");
+    display.fillRect(100, 60, 5, 2, 13);
+    display.display();
+    expect_strip(emu, display, 48, "shadow");
+
+    EXPECT(!display.enablePartialDisplay(56, 16), "strip past the bottom");
+    EXPECT(!display.enablePartialDisplay(48, 15) == sh1122,
+           "%s: 15-row strip", controller(sh1122));
+    EXPECT(display.enablePartialDisplay(48, 16), "back to 16 rows");
+
+    EXPECT(display.disablePartialDisplay(), "disablePartialDisplay failed");
+    display.display();
+    expect_panel(emu, display.getBuffer(), "full panel again");
+    display.setRotation(2);
+    display.fillRect(0, 0, 30, 30, 5);
+    display.display();
+    expect_panel(emu, display.getBuffer(), "rotated");
+    display.setRotation(0);
+
+    // After scrolling, the strip's rows sit further on in display RAM; 70
+    // rows takes the SSD1322's strip past the end of it.
+    for (int scroll = 20; scroll <= 70; scroll += 50) {
+      display.scrollVertical(scroll);
+      display.display();
+      EXPECT(display.enablePartialDisplay(48, 16), "strip after a scroll");
+      display.fillRect(scroll, 50, 40, 8, 14);
+      display.display();
+      expect_strip(emu, display, 48, "scrolled");
+      EXPECT(display.disablePartialDisplay(), "disable after a scroll");
+      display.display();
+      expect_panel(emu, display.getBuffer(), "scrolled full panel");
+    }
+
+    // Turning the panel round by hardware keeps the strip on the same
+    // panel rows, the right way up.
+    display.setHardwareFlip(true);
+    EXPECT(display.enablePartialDisplay(48, 16), "strip before the flip");
+    display.setCursor(4, 52);
+    display.print("flip");
+    display.display();
+    expect_strip(emu, display, 48, "before the flip");
+    static uint8_t before[16 * 128];
+    memcpy(before, display.getBuffer(), sizeof(before));
+    display.setRotation(2);
+    display.display();
+    expect_strip(emu, display, 0, "flipped");
+    for (int i = 0; i < (int)sizeof(before); i++) {
+      uint8_t b = before[sizeof(before) - 1 - i];
+      EXPECT(display.getBuffer()[i] == uint8_t((b >> 4) | (b << 4)),
+             "flipped strip byte %d", i);
+    }
+    EXPECT(display.disablePartialDisplay(), "disable after the flip");
+    EXPECT(display.enablePartialDisplay(48, 16), "strip while flipped");
+    display.display();
+    expect_strip(emu, display, 0, "enabled while flipped");
+    EXPECT(display.disablePartialDisplay(), "disable while flipped");
+    display.setHardwareFlip(false);
+  }
+  printf("partial ok\n");
+}
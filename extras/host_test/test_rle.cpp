@@ -0,0 +1,104 @@
+// Run-length images made by tools/rle_encode.py from the PGM files in
+// data/: every frame of an animation decodes to its source image, clipped
+// and rotated like any other drawing, and a key frame streams to the panel.
+
+#include "harness.h"
+
+#include <ctype.h>
+#include <rle_anim.h>
+#include <rle_key.h>
+
+// Read a P2 or P5 PGM file as gray levels, scaled as the encoder does.
+static void read_pgm(const char *name, int w, int h, uint8_t *levels) {
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s", HOST_DATA, name);
+  FILE *f = fopen(path, "rb");
+  EXPECT(f, "can't open %s", path);
+  char magic[3] = {0};
+  int fields[3];
+  EXPECT(fread(magic, 1, 2, f) == 2, "%s: no header", path);
+  for (int i = 0; i < 3; i++) {
+    int c = fgetc(f);
+    while (isspace(c) || (c == '#')) {
+      if (c == '#') {
+        while ((c != '\n') && (c != EOF)) {
+          c = fgetc(f);
+        }
+      }
+      c = fgetc(f);
+    }
+    ungetc(c, f);
+    EXPECT(fscanf(f, "%d", &fields[i]) == 1, "%s: bad header", path);
+  }
+  EXPECT((fields[0] == w) && (fields[1] == h), "%s: not %dx%d", path, w, h);
+  int maxval = fields[2];
+  fgetc(f);
+  for (int i = 0; i < w * h; i++) {
+    int value;
+    if (magic[1] == '5') {
+      value = fgetc(f);
+    } else {
+      EXPECT(fscanf(f, "%d", &value) == 1, "%s: short", path);
+    }
+    levels[i] = (value * 15 + maxval / 2) / maxval;
+  }
+  fclose(f);
+}
+
+int main() {
+  static uint8_t frames[4][100 * 40];
+  const char *names[] = {"frame0.pgm", "frame1.pgm", "frame2.pgm",
+                         "frame3.pgm"};
+  for (int f = 0; f < 4; f++) {
+    read_pgm(names[f], 100, 40, frames[f]);
+  }
+
+  Emulator emu(false, TEST_DC, TEST_CS);
+  for (int rotation = 0; rotation < 4; rotation++) {
+    for (int place = 0; place < 4; place++) {
+      Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+      EXPECT(display.begin(), "begin() failed");
+      display.setRotation(rotation);
+      Reference ref;
+      ref.setRotation(rotation);
+      // Inside, and off the left, right and top edges
+      const int xs[] = {3, -17, 200, 0}, ys[] = {20, 20, 20, -9};
+      int x = xs[place], y = ys[place];
+      EXPECT(display.getRLEFrames(rle_anim) == 4, "frame count");
+      for (int f = 0; f < 4; f++) {
+        EXPECT(display.drawRLEImage(x, y, rle_anim, f), "frame %d decode", f);
+        for (int j = 0; j < 40; j++) {
+          for (int i = 0; i < 100; i++) {
+            ref.drawPixel(x + i, y + j, frames[f][j * 100 + i]);
+          }
+        }
+        EXPECT(!memcmp(display.getBuffer(), ref.getBuffer(), 8192),
+               "rotation %d at %d,%d, frame %d", rotation, x, y, f);
+      }
+      if (rotation == 0) {
+        display.display();
+        expect_panel(emu, display.getBuffer(), "animation");
+      }
+    }
+  }
+
+  static uint8_t key[100 * 40];
+  read_pgm("key.pgm", 100, 40, key);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  display.display();
+  EXPECT(!display.streamRLEImage(8, 4, rle_anim, 1),
+         "streamed a difference frame");
+  EXPECT(display.streamRLEImage(8, 4, rle_key), "stream failed");
+  for (int j = 0; j < 40; j++) {
+    for (int i = 0; i < 100; i++) {
+      int x = 8 + i;
+      uint8_t b = emu.visible(4 + j, x / 2, 256);
+      uint8_t level = (x & 1) ? (b & 0x0F) : (b >> 4);
+      EXPECT(level == key[j * 100 + i], "streamed pixel %d,%d", i, j);
+    }
+  }
+  printf("animation %zu bytes, key frame %zu bytes\n", sizeof(rle_anim),
+         sizeof(rle_key));
+  printf("rle ok\n");
+}
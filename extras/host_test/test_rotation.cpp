@@ -0,0 +1,121 @@
+// Drawing in every rotation, with and without setHardwareFlip(). With the
+// flip on, rotations 2 and 3 keep the frame buffer turned 180 degrees, so
+// it is compared turned back. Grayscale images are checked against
+// drawing them a pixel at a time, and getPixel() reads back what was
+// drawn.
+
+#include "harness.h"
+
+static const uint8_t *unflipped(Adafruit_SSD1322 &display, bool flipped) {
+  static uint8_t turned[8192];
+  if (!flipped) {
+    return display.getBuffer();
+  }
+  for (int i = 0; i < 8192; i++) {
+    uint8_t b = display.getBuffer()[8191 - i];
+    turned[i] = (b >> 4) | (b << 4);
+  }
+  return turned;
+}
+
+int main() {
+  srand(7);
+  static RandomFont font;
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    Emulator emu(sh1122, TEST_DC, TEST_CS);
+    Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+    EXPECT(display.begin(), "begin() failed");
+    Reference ref;
+    display.setFont(&font.font);
+    ref.setFont(&font.font);
+    for (int flip = 0; flip < 2; flip++) {
+      display.setHardwareFlip(flip);
+      for (int rotation = 0; rotation < 4; rotation++) {
+        display.setRotation(rotation);
+        ref.setRotation(rotation);
+        bool flipped = flip && (rotation & 2);
+        EXPECT(!memcmp(unflipped(display, flipped), ref.getBuffer(), 8192),
+               "after setRotation(%d)", rotation);
+        for (int i = 0; i < 1500; i++) {
+          int kind = rand() % 9;
+          int x = rand() % 300 - 30, y = rand() % 300 - 30;
+          int w = rand() % 60 + 1, h = rand() % 40 + 1;
+          int color = rand() & 15, bg = rand() & 15;
+          uint8_t *bitmap = font.bits + rand() % 1000;
+          switch (kind) {
+          case 0:
+            display.drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color);
+            ref.drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color);
+            break;
+          case 1:
+            display.drawBitmap(x, y, bitmap, w, h, color, bg);
+            ref.drawBitmap(x, y, bitmap, w, h, color, bg);
+            break;
+          case 2: {
+            char text[12];
+            for (int c = 0; c < 11; c++) {
+              text[c] = 32 + rand() % 96;
+            }
+            text[11] = 0;
+            display.setTextColor(color);
+            ref.setTextColor(color);
+            display.drawText(x, y, text);
+            ref.setCursor(x, y);
+            ref.print(text);
+            break;
+          }
+          case 3:
+            display.fillRect(x, y, w, h, color);
+            ref.fillRect(x, y, w, h, color);
+            break;
+          case 4:
+            display.drawFastHLine(x, y, w, color);
+            ref.drawFastHLine(x, y, w, color);
+            break;
+          case 5:
+            display.drawFastVLine(x, y, h, color);
+            ref.drawFastVLine(x, y, h, color);
+            break;
+          case 7:
+            display.drawGrayBitmap4(x, y, bitmap, w, h);
+            for (int j = 0; j < h; j++) {
+              for (int k = 0; k < w; k++) {
+                ref.drawPixel(x + k, y + j, nibble(bitmap, (w + 1) / 2, k, j));
+              }
+            }
+            break;
+          case 8:
+            display.drawGrayBitmap8(x, y, bitmap, w, h);
+            for (int j = 0; j < h; j++) {
+              for (int k = 0; k < w; k++) {
+                ref.drawPixel(x + k, y + j,
+                              (((bitmap[j * w + k] * 240 + 127) / 255) + 8) >> 4);
+              }
+            }
+            break;
+          default:
+            display.drawPixel(x, y, color);
+            ref.drawPixel(x, y, color);
+            break;
+          }
+          EXPECT(!memcmp(unflipped(display, flipped), ref.getBuffer(), 8192),
+                 "%s, flip %d, rotation %d, draw %d (kind %d at %d,%d %dx%d)",
+                 controller(sh1122), flip, rotation, i, kind, x, y, w, h);
+          int px = rand() % display.width(), py = rand() % display.height();
+          EXPECT((display.getPixel(px, py) != 0) == ref.getPixel(px, py),
+                 "getPixel(%d, %d), flip %d, rotation %d", px, py, flip,
+                 rotation);
+          display.drawPixel(px, py, color);
+          ref.drawPixel(px, py, color);
+          EXPECT(display.getPixel(px, py) == color, "getPixel(%d, %d) after "
+                 "drawPixel, flip %d, rotation %d", px, py, flip, rotation);
+          if (i % 97 == 0) {
+            display.display();
+            expect_panel(emu, display.getBuffer(), "update");
+          }
+        }
+      }
+    }
+  }
+  printf("rotation ok\n");
+}
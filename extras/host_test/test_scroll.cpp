@@ -0,0 +1,76 @@
+// scrollVertical(): scrolling the frame buffer and the panel's start line
+// together keeps the panel in step, with each flush mode. With a pixel
+// shift on, the SSD1322 rows the shift can show stay blank.
+
+#include "harness.h"
+
+int main() {
+  const char *modes[] = {"plain", "shadow", "async"};
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    for (int mode = 0; mode < 3; mode++) {
+      Emulator emu(sh1122, TEST_DC, TEST_CS);
+      Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+      EXPECT(display.begin(), "begin() failed");
+      if (mode == 1) {
+        display.enableShadowBuffer();
+      } else if (mode == 2) {
+        display.enableAsyncDisplay();
+      }
+      srand(9);
+      long total = 0;
+      for (int i = 0; i < 300; i++) {
+        display.fillRect(rand() % 256, rand() % 64, rand() % 50, rand() % 20,
+                         rand() & 15);
+        int rows = rand() % 21 - 10;
+        if (rand() % 10 == 0) {
+          rows = rand() % 140 - 70;
+        }
+        display.scrollVertical(rows);
+        display.fillRect(0, 56, 100, 8, rand() & 15);
+        emu.resetCounts();
+        if (mode == 2) {
+          display.displayAsync();
+          display.waitForDisplay();
+        } else {
+          display.display();
+        }
+        total += emu.bytes;
+        EXPECT(!emu.compare(display.getBuffer(), 256, 64), "%s %s, scroll %d",
+               controller(sh1122), modes[mode], i);
+      }
+      printf("%s %s: %ld bytes per update\n", controller(sh1122), modes[mode],
+             total / 300);
+    }
+  }
+
+  // A log view: one new line of text per scroll
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  display.fillScreen(5);
+  display.display();
+  emu.resetCounts();
+  display.scrollVertical(8);
+  display.setCursor(0, 56);
+  display.print("new line");
+  display.display();
+  expect_panel(emu, display.getBuffer(), "log view");
+  EXPECT(emu.bytes < 8192 / 4, "log view scroll took %ld bytes", emu.bytes);
+
+  // The rows just below and above the picture, which a display offset of
+  // up to 3 shows.
+  display.setPixelShift(3);
+  for (int i = 0; i < 20; i++) {
+    for (int y = 0; y < 6; y++) {
+      int row = (y < 3) ? 64 + y : 128 - 6 + y;
+      for (int xb = 0; xb < 128; xb++) {
+        EXPECT(!emu.visible(row, xb, 256), "RAM row %d not blank, scroll %d",
+               row, i);
+      }
+    }
+    display.scrollVertical(rand() % 100 - 50);
+    display.display();
+  }
+  expect_panel(emu, display.getBuffer(), "scrolled with pixel shift");
+  printf("scroll ok\n");
+}
@@ -0,0 +1,38 @@
+// Software SPI, decoded from the MOSI and SCK pins. In the fastpin build
+// the library bitbangs through the port registers instead of
+// Adafruit_SPIDevice, and must clock exactly the same bytes no faster than
+// the controller's serial timing allows.
+
+#include "harness.h"
+
+int main() {
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    Emulator emu(sh1122, TEST_DC, TEST_CS);
+    emu.connectSoftSPI(TEST_MOSI, TEST_SCLK);
+    Adafruit_SSD1322 display(TEST_MOSI, TEST_SCLK, TEST_DC, -1, TEST_CS,
+                             variant(sh1122));
+    EXPECT(display.begin(), "begin() failed");
+    EXPECT(emu.on, "%s not turned on", controller(sh1122));
+    srand(3);
+    for (int i = 0; i < 60; i++) {
+      for (int k = 0; k < 3; k++) {
+        display.fillRect(rand() % 256, rand() % 64, rand() % 100 + 1,
+                         rand() % 30 + 1, rand() % 16);
+      }
+      for (int k = 0; k < 20; k++) {
+        display.drawPixel(rand() % 256, rand() % 64, rand() % 16);
+      }
+      if (i == 10) {
+        display.clearDisplay();
+      } else if (i == 20) {
+        display.fillScreen(15);
+      }
+      display.display();
+      expect_panel(emu, display.getBuffer(), "update");
+    }
+    EXPECT(!emu.errors, "%ld bus errors", emu.errors);
+    printf("%s: %ld bytes, %ld selects, %ld DC toggles\n", controller(sh1122),
+           emu.bytes, emu.selects, emu.dc_toggles);
+  }
+  printf("soft ok\n");
+}
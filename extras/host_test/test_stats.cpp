@@ -0,0 +1,56 @@
+// enableStats() counts against the bus, and setMaxFrameRate() pacing.
+
+#include "harness.h"
+
+int main() {
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  display.display();
+  EXPECT(display.enableStats(), "no stats");
+  const Adafruit_SSD1322::Stats *stats = display.getStats();
+
+  emu.resetCounts();
+  display.fillRect(10, 10, 20, 5, 3);
+  display.fillRect(100, 40, 8, 8, 9);
+  display.display();
+  printf("%u bytes, %u windows, %u commands, %u DC toggles, %u us\n",
+         stats->bytes, stats->windows, stats->commands, stats->dc_toggles,
+         stats->micros);
+  EXPECT(long(stats->bytes) == emu.bytes, "stats say %u bytes, bus saw %ld",
+         stats->bytes, emu.bytes);
+  EXPECT(long(stats->commands) == emu.commands,
+         "stats say %u commands, bus saw %ld", stats->commands, emu.commands);
+  EXPECT(long(stats->dc_toggles) == emu.dc_toggles,
+         "stats say %u DC toggles, bus saw %ld", stats->dc_toggles,
+         emu.dc_toggles);
+
+  // 1000 updates over about a second, limited to 10 per second
+  display.setMaxFrameRate(10);
+  int sent = 0;
+  for (int i = 0; i < 1000; i++) {
+    display.drawPixel(i % 256, 5, i & 15);
+    uint32_t frames = stats->frames;
+    display.display();
+    if (stats->frames != frames) {
+      sent++;
+    }
+    delay(1);
+  }
+  printf("paced: %d sent, %u skipped, %.2f fps\n", sent, stats->skipped,
+         stats->fps);
+  EXPECT((sent >= 9) && (sent <= 12), "%d updates sent at 10 fps", sent);
+  // A skipped update is sent by a later display().
+  delay(200);
+  display.display();
+  expect_panel(emu, display.getBuffer(), "after pacing");
+
+  display.setMaxFrameRate(20, true);
+  for (int i = 0; i < 20; i++) {
+    display.drawPixel(i, 6, 7);
+    display.display();
+  }
+  printf("waiting: %.2f fps, %u skipped\n", stats->fps, stats->skipped);
+  EXPECT(stats->fps < 21, "%.2f fps at a 20 fps limit", stats->fps);
+  printf("stats ok\n");
+}
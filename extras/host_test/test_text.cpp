@@ -0,0 +1,66 @@
+// 1bpp bitmaps and GFX fonts drawn straight into the 4bpp buffer, against
+// GFX's own drawing.
+
+#include "harness.h"
+
+int main() {
+  srand(7);
+  static RandomFont font;
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  Reference ref;
+  for (int i = 0; i < 3000; i++) {
+    int kind = rand() % 5;
+    int x = rand() % 300 - 30, y = rand() % 100 - 30;
+    int w = rand() % 40 + 1, h = rand() % 30 + 1;
+    int color = rand() & 15, bg = rand() & 15;
+    uint8_t *bitmap = font.bits + rand() % 1000;
+    switch (kind) {
+    case 0:
+      display.drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color);
+      ref.drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color);
+      break;
+    case 1:
+      display.drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color, bg);
+      ref.drawBitmap(x, y, (const uint8_t *)bitmap, w, h, color, bg);
+      break;
+    case 2:
+      display.drawBitmap(x, y, bitmap, w, h, color, bg);
+      ref.drawBitmap(x, y, bitmap, w, h, color, bg);
+      break;
+    case 3: {
+      char text[12];
+      for (int c = 0; c < 11; c++) {
+        text[c] = 32 + rand() % 96;
+      }
+      text[11] = 0;
+      if (rand() % 3 == 0) {
+        text[5] = '\n';
+      }
+      display.setFont(&font.font);
+      ref.setFont(&font.font);
+      display.setTextColor(color);
+      ref.setTextColor(color);
+      display.drawText(x, y, text);
+      ref.setCursor(x, y);
+      ref.print(text);
+      EXPECT((display.getCursorX() == ref.getCursorX()) &&
+                 (display.getCursorY() == ref.getCursorY()),
+             "cursor after \"%s\"", text);
+      break;
+    }
+    default:
+      display.fillRect(x, y, w, h, color);
+      ref.fillRect(x, y, w, h, color);
+      break;
+    }
+    EXPECT(!memcmp(display.getBuffer(), ref.getBuffer(), 8192),
+           "draw %d (kind %d at %d,%d %dx%d)", i, kind, x, y, w, h);
+    if (i % 97 == 0) {
+      display.display();
+      expect_panel(emu, display.getBuffer(), "update");
+    }
+  }
+  printf("text ok\n");
+}
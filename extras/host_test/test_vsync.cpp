@@ -0,0 +1,101 @@
+// enableVsync(): refresh periods from the clock settings, setRefreshRate()
+// and the FR pin, and updates timed to the refresh still reaching the
+// panel in every rotation. Two displays with FR pins each measure their
+// own panel, and a group's update isn't held back by its panels' scans.
+
+#include "harness.h"
+
+#include <Adafruit_SSD1322_Group.h>
+
+#define TEST_FR 2
+#define TEST_FR2 3
+
+int main() {
+  for (int sh1122 = 0; sh1122 < 2; sh1122++) {
+    Emulator emu(sh1122, TEST_DC, TEST_CS);
+    Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS, variant(sh1122));
+    EXPECT(display.begin(), "begin() failed");
+    uint32_t period = display.getRefreshPeriod();
+    printf("%s: estimated refresh period %u us\n", controller(sh1122),
+           (unsigned)period);
+    EXPECT((period > 5000) && (period < 25000), "estimate %u us",
+           (unsigned)period);
+    display.setRefreshRate(50);
+    EXPECT(display.getRefreshPeriod() == 20000, "setRefreshRate(50)");
+    display.setRefreshRate(0);
+    EXPECT(display.getRefreshPeriod() == period, "estimate not restored");
+
+    EXPECT(display.enableVsync(), "enableVsync failed");
+    for (int rotation = 0; rotation < 4; rotation++) {
+      display.setRotation(rotation);
+      for (int i = 0; i < 5; i++) {
+        display.fillRect(i * 7, i * 5, 30, 9, (i + rotation) & 15);
+        display.drawPixel(200, 60, 15);
+        unsigned long start = micros();
+        display.display();
+        unsigned long taken = micros() - start;
+        EXPECT(taken < 2 * period + 50000, "update took %lu us", taken);
+        expect_panel(emu, display.getBuffer(), "timed update");
+      }
+    }
+
+    // FR pulses every 12 ms
+    EXPECT(display.enableVsync(true, TEST_FR), "enableVsync with FR failed");
+    for (int i = 0; i < 3; i++) {
+      delay(12);
+      host_interrupt(TEST_FR);
+    }
+    EXPECT(display.getRefreshPeriod() == 12000, "measured period %u us",
+           (unsigned)display.getRefreshPeriod());
+    display.fillRect(0, 0, 256, 64, 9);
+    display.display();
+    expect_panel(emu, display.getBuffer(), "update timed to FR");
+    display.enableVsync(false);
+  }
+
+  // Two displays with their own FR pins, pulsing every 12 ms and 7 ms
+  Emulator emu1(false, TEST_DC, 20), emu2(false, TEST_DC, 21);
+  Adafruit_SSD1322 first(&SPI, TEST_DC, -1, 20), second(&SPI, TEST_DC, -1, 21);
+  EXPECT(first.begin() && second.begin(), "begin() failed");
+  EXPECT(first.enableVsync(true, TEST_FR), "enableVsync on the first failed");
+  EXPECT(second.enableVsync(true, TEST_FR2),
+         "enableVsync on the second failed");
+  for (int ms = 1; ms <= 84; ms++) {
+    delay(1);
+    if (ms % 12 == 0) {
+      host_interrupt(TEST_FR);
+    }
+    if (ms % 7 == 0) {
+      host_interrupt(TEST_FR2);
+    }
+  }
+  EXPECT(first.getRefreshPeriod() == 12000, "first measured %u us",
+         (unsigned)first.getRefreshPeriod());
+  EXPECT(second.getRefreshPeriod() == 7000, "second measured %u us",
+         (unsigned)second.getRefreshPeriod());
+
+  // Most of a refresh after the last FR edge on each panel is too late to
+  // start the bottom rows, but the group sends straight away. The edges
+  // keep each panel's period.
+  Adafruit_SSD1322 *panels[2] = {&first, &second};
+  Adafruit_SSD1322_Group group(panels, 2, 1);
+  group.display();
+  group.fillRect(0, 60, 512, 4, 7);
+  host_interrupt(TEST_FR);
+  delayMicroseconds(9800);
+  host_interrupt(TEST_FR2);
+  delayMicroseconds(2200);
+  host_interrupt(TEST_FR);
+  delayMicroseconds(4800);
+  host_interrupt(TEST_FR2);
+  delayMicroseconds(6300);
+  unsigned long start = micros();
+  group.display();
+  unsigned long taken = micros() - start;
+  EXPECT(taken < 1300, "group update took %lu us", taken);
+  expect_panel(emu1, first.getBuffer(), "first panel");
+  expect_panel(emu2, second.getBuffer(), "second panel");
+  first.enableVsync(false);
+  second.enableVsync(false);
+  printf("vsync ok\n");
+}
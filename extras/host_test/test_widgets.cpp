@@ -0,0 +1,79 @@
+// Adafruit_SSD1322_Scene: only widgets whose value changed are redrawn and
+// sent.
+
+#include "harness.h"
+
+#include <Adafruit_SSD1322_Widgets.h>
+#include <limits.h>
+
+static const uint8_t icon_a[] = {0xFF, 0x81, 0x81, 0x81,
+                                 0x81, 0x81, 0x81, 0xFF};
+static const uint8_t icon_b[] = {0x18, 0x3C, 0x7E, 0xFF,
+                                 0xFF, 0x7E, 0x3C, 0x18};
+
+int main() {
+  Emulator emu(false, TEST_DC, TEST_CS);
+  Adafruit_SSD1322 display(&SPI, TEST_DC, -1, TEST_CS);
+  EXPECT(display.begin(), "begin() failed");
+  display.display();
+  display.enableStats();
+  const Adafruit_SSD1322::Stats *stats = display.getStats();
+
+  Adafruit_SSD1322_Scene scene(display);
+  Adafruit_SSD1322_Label *labels[20];
+  for (int i = 0; i < 20; i++) {
+    labels[i] = new Adafruit_SSD1322_Label((i % 5) * 50, (i / 5) * 16, 48, 8);
+    scene.add(*labels[i]);
+    labels[i]->setNumber(i * 100);
+  }
+  Adafruit_SSD1322_Bar bar(0, 56, 100, 8, 0, 1000);
+  Adafruit_SSD1322_Icon icon(240, 0, 8, 8, icon_a);
+  uint8_t samples[64];
+  Adafruit_SSD1322_Sparkline spark(150, 40, 64, 16, samples, 0, 100, 9);
+  scene.add(bar);
+  scene.add(icon);
+  scene.add(spark);
+
+  int drawn = scene.update();
+  printf("first update: %d widgets, %u bytes\n", drawn, stats->bytes);
+  EXPECT(drawn == 23, "%d widgets drawn at first", drawn);
+  expect_panel(emu, display.getBuffer(), "first update");
+
+  labels[7]->setNumber(701);
+  drawn = scene.update();
+  printf("one label: %d widget, %u bytes, %u windows\n", drawn, stats->bytes,
+         stats->windows);
+  EXPECT(drawn == 1, "%d widgets drawn for one label", drawn);
+
+  labels[7]->setNumber(701);
+  bar.setValue(0);
+  drawn = scene.update(false);
+  EXPECT(drawn == 0, "%d widgets drawn with nothing changed", drawn);
+
+  bar.setValue(500);
+  icon.setBitmap(icon_b);
+  for (int i = 0; i < 70; i++) {
+    spark.addValue(i * 3 % 100);
+  }
+  drawn = scene.update();
+  printf("bar, icon and sparkline: %d widgets, %u bytes\n", drawn,
+         stats->bytes);
+  EXPECT(drawn == 3, "%d widgets drawn for three", drawn);
+  expect_panel(emu, display.getBuffer(), "three widgets");
+
+  // setNumber() keeps every digit of the longest long.
+  char longest[32];
+  snprintf(longest, sizeof(longest), "%ld", LONG_MIN);
+  labels[4]->setText(longest);
+  scene.update();
+  labels[4]->setNumber(LONG_MIN);
+  EXPECT(!labels[4]->isDirty(), "setNumber(LONG_MIN) gave other text");
+
+  labels[3]->setVisible(false);
+  scene.update();
+  expect_panel(emu, display.getBuffer(), "hidden label");
+  for (int i = 0; i < 20; i++) {
+    delete labels[i];
+  }
+  printf("widgets ok\n");
+}
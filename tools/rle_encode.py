@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""Convert PGM images into run-length compressed 4bpp data for
+Adafruit_SSD1322::drawRLEImage() and streamRLEImage().
+
+Each input file becomes one frame. Frames after the first are stored as
+differences from the frame before, so an animation only pays for the pixels
+that change. The output is a C header with the data in PROGMEM:
+
+    python3 tools/rle_encode.py -n boot_anim frame0.pgm frame1.pgm ... > boot_anim.h
+
+Token format (see drawRLEImage() in Adafruit_SSD1322.cpp):
+    0LLLGGGG           run of L+1 (1-8) pixels of gray level G
+    10NNNNNN ...       N+1 (1-64) literal pixels, two per byte, left one high
+    1100GGGG nnnnnnnn  run of n+9 (9-264) pixels of gray level G
+    0xD0-0xFE          skip 1-47 pixels
+    0xFF nnnn          skip a 16-bit count of pixels
+"""
+
+import argparse
+import sys
+
+SKIP = None
+
+
+def read_pgm(path):
+    """Read a binary (P5) or ASCII (P2) PGM file into (width, height, pixels)."""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        # Skip whitespace and comments between header fields.
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            while data[pos:pos + 1] not in (b'\n', b''):
+                pos += 1
+            continue
+        start = pos
+        while not data[pos:pos + 1].isspace():
+            pos += 1
+        fields.append(data[start:pos])
+    magic, width, height, maxval = fields[0], int(fields[1]), int(fields[2]), int(fields[3])
+
+    if magic == b'P5':
+        pos += 1
+        if maxval < 256:
+            pixels = list(data[pos:pos + width * height])
+        else:
+            pixels = [(data[pos + i * 2] << 8) | data[pos + i * 2 + 1] for i in range(width * height)]
+    elif magic == b'P2':
+        pixels = [int(v) for v in data[pos:].split()][:width * height]
+    else:
+        sys.exit('%s: not a PGM file' % path)
+    if len(pixels) != width * height:
+        sys.exit('%s: truncated image data' % path)
+
+    # Scale to the panel's 16 gray levels.
+    return width, height, [(p * 15 + maxval // 2) // maxval for p in pixels]
+
+
+def encode_frame(pixels):
+    """Encode a list of gray levels (or SKIP) into tokens."""
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:64]
+            del literal[:64]
+            out.append(0x80 | (len(chunk) - 1))
+            if len(chunk) & 1:
+                chunk = chunk + [0]
+            for i in range(0, len(chunk), 2):
+                out.append((chunk[i] << 4) | chunk[i + 1])
+
+    i = 0
+    while i < len(pixels):
+        value = pixels[i]
+        n = 1
+        while i + n < len(pixels) and pixels[i + n] == value:
+            n += 1
+
+        if value is SKIP:
+            flush_literal()
+            left = n
+            while left > 47:
+                count = min(left, 0xFFFF)
+                out += bytes((0xFF, count & 0xFF, count >> 8))
+                left -= count
+            if left:
+                out.append(0xD0 + left - 1)
+        elif n >= 3:
+            # A run costs one or two bytes, against half a byte per pixel as a literal.
+            flush_literal()
+            left = n
+            while left > 0:
+                count = min(left, 264)
+                if count <= 8:
+                    out.append(((count - 1) << 4) | value)
+                else:
+                    out += bytes((0xC0 | value, count - 9))
+                left -= count
+        else:
+            literal += [value] * n
+        i += n
+
+    flush_literal()
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('images', nargs='+', help='PGM files, one per frame')
+    parser.add_argument('-n', '--name', default='rle_image', help='C array name')
+    parser.add_argument('--no-delta', action='store_true',
+                        help='store every frame in full instead of as changes')
+    args = parser.parse_args()
+
+    width = height = None
+    previous = None
+    frames = []
+    for path in args.images:
+        w, h, pixels = read_pgm(path)
+        if width is None:
+            width, height = w, h
+        elif (w, h) != (width, height):
+            sys.exit('%s: all frames must be %dx%d' % (path, width, height))
+
+        if previous is not None and not args.no_delta:
+            frame = [SKIP if p == q else p for p, q in zip(pixels, previous)]
+        else:
+            frame = pixels
+        frames.append(encode_frame(frame))
+        previous = pixels
+
+    data = bytearray()
+    for value in (width, height, len(frames)):
+        data += bytes((value & 0xFF, value >> 8))
+    for frame in frames:
+        if len(frame) > 0xFFFF:
+            sys.exit('frame too large')
+        data += bytes((len(frame) & 0xFF, len(frame) >> 8)) + frame
+
+    raw = (width + 1) // 2 * height * len(frames)
+    print('// %s: %dx%d, %d frame(s), %d bytes (%d uncompressed)'
+          % (args.name, width, height, len(frames), len(data), raw))
+    print('// Generated by tools/rle_encode.py from %s' % ' '.join(args.images))
+    print('const uint8_t %s[] PROGMEM = {' % args.name)
+    for i in range(0, len(data), 16):
+        print('  ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+    print('};')
+
+
+if __name__ == '__main__':
+    main()